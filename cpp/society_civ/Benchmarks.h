@@ -0,0 +1,102 @@
+#pragma once
+
+// Benchmark and report entry points (implemented in benchmarks.cpp).
+// Each returns a process exit code and prints its report to stdout.
+
+// Runs x societies x evaluations all in parallel on the shared TaskRuntime;
+// reports thread counts against the cap and wall time against a serial baseline.
+int bench_nested_parallelism();
+
+// Evaluations-to-target on both shipped problems, fixed vs self-adaptive
+// region probabilities in the Information Acquisition Operator.
+int bench_adaptive_operators();
+
+// Evaluations-to-first-feasible with and without the epsilon-constrained
+// feasibility schedule.
+int bench_epsilon_schedule();
+
+// Portfolio of differently configured civilizations with budget reallocation,
+// against each configuration run alone on the same evaluation budget.
+int bench_portfolio();
+
+// Prediction accuracy and batch makespan of longest-predicted-first
+// evaluation dispatch on a workload whose cost depends on the design.
+int bench_cost_scheduling();
+
+// Recall, distance computations and time of LSH nearest-leader search against
+// brute force, on synthetic high-dimensional leader sets and in the engine.
+int bench_lsh_nearest();
+
+// Checks that an out-of-core run and runs resumed from a checkpoint match an
+// in-memory run exactly and that damaged checkpoints are rejected, then
+// compares resident memory and pass times in memory and out of core.
+int bench_population_storage();
+
+// Runs a problem through HttpEvaluator against a local stand-in evaluation
+// server: per-design vs batched/pipelined requests, JSON vs binary, retries.
+int bench_http_evaluator();
+
+// Concurrent runs sharing a license-token budget (in-process pool and two
+// pools coordinating through a lock-file directory): peak concurrent
+// evaluations against the budget and per-run wait time.
+int bench_license_budget();
+
+// Quality and global-phase cost with leaders capped at top-k per society
+// (and k super leaders) against the paper's unbounded selection.
+int bench_leader_cap();
+
+// Throughput of the memory-mapped, parallel trajectory CSV reader against a
+// getline/stringstream parse, plus binary conversion and validation.
+int bench_csv_reader();
+
+// Per-run, per-step trajectory metrics (parallel across runs) against a
+// script-style stream parse with map/set grouping.
+int bench_trajectory_analytics();
+
+// Throughput of the block writer (pwrite, io_uring, io_uring + O_DIRECT)
+// against std::ofstream for binary dumps and CSV trajectory logging.
+int bench_block_writer();
+
+// Per-run setup cost of a new Civilization against reseed() of pooled
+// engines, checking that both give identical runs.
+int bench_engine_reuse();
+
+// Step cost and log size with influence tracking on and off, plus the cost
+// of rebuilding influence trees from the binary log.
+int bench_influence_log();
+
+// p50/p99 step time and allocations per step at m=200 (by-value constraints
+// against the constraint writer with reserved buffers), plus step_for() ticks.
+int bench_step_latency();
+
+// Welded-beam sweeps over load, length and stress limits solved cold and with
+// continuation (ContinuationSweep): evaluations saved and objective change.
+int bench_continuation();
+
+// Evaluations, evaluations wasted on cheap-infeasible points and solution
+// quality with no repair, projection and rejection against g3/g5.
+int bench_cheap_repair();
+
+// Step phase times, and all-pairs distances read through the Individuals
+// against one flat copy.
+int bench_hot_cold();
+
+// Evaluations to target with every follower moving, uniform thinning and
+// bandit allocation of moves across societies.
+int bench_evaluation_bandit();
+
+// Concurrent runs against a stand-in evaluation service, one call per run
+// and step vs batches coalesced across runs.
+int bench_evaluation_coalescer();
+
+// Society-size distribution, global society, step time and quality with
+// a hub-count cap and merging of small societies.
+int bench_society_limits();
+
+// Distances computed, reused and pruned by the hub-center clustering; fails
+// unless every clustering equals an unpruned reference.
+int bench_cluster_pruning();
+
+// Records the evaluations of a run against a slow stand-in simulator and
+// replays them from memory for the same seed.
+int bench_evaluation_replay();
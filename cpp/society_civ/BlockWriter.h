@@ -0,0 +1,453 @@
+#pragma once
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ostream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define CIV_HAVE_IO_URING 1
+#endif
+#endif
+
+#ifdef _WIN32
+#include <malloc.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#ifdef CIV_HAVE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+// Append-only file writer for logs and binary dumps.
+//
+// Data is formatted or copied straight into a small ring of large aligned
+// blocks (stream() writes into them with no intermediate buffer). A full
+// block is handed to the kernel and the writer moves on to the next one:
+//   - Linux with io_uring: the blocks are registered buffers, writes are
+//     IORING_OP_WRITE_FIXED submitted 'submit_batch' at a time, and the
+//     stepping thread only waits when every block is still in flight.
+//     Optionally the file is opened with O_DIRECT (blocks and offsets are
+//     page-aligned; the padded tail is truncated on close).
+//   - Elsewhere, or where io_uring is unavailable (old kernels, seccomp):
+//     one pwrite()/fwrite() per block.
+// Errors throw std::runtime_error, as the std::ofstream code it replaces
+// would have reported through its stream state.
+class BlockWriter {
+public:
+    struct Options {
+        size_t block_size = 1 << 20; // rounded up to a multiple of ALIGN
+        int queue_depth = 4;         // blocks in the ring
+        int submit_batch = 2;        // full blocks queued per io_uring_enter
+        bool use_io_uring = true;
+        bool direct = false;         // O_DIRECT (Linux; ignored where unsupported)
+    };
+
+    struct Stats {
+        long long bytes = 0;
+        long long blocks = 0;   // block writes issued
+        long long syscalls = 0; // write / io_uring_enter calls
+    };
+
+    static constexpr size_t ALIGN = 4096;
+
+    BlockWriter() : m_stream(&m_buf) { m_buf.owner = this; }
+    explicit BlockWriter(const std::string& path) : BlockWriter() { open(path, Options()); }
+    BlockWriter(const std::string& path, const Options& options) : BlockWriter() { open(path, options); }
+    ~BlockWriter() {
+        try { close(); }
+        catch (...) {}
+    }
+
+    BlockWriter(const BlockWriter&) = delete;
+    BlockWriter& operator=(const BlockWriter&) = delete;
+
+    void open(const std::string& path, const Options& options) {
+        close();
+        m_options = options;
+        m_options.block_size = std::max<size_t>(ALIGN, (options.block_size + ALIGN - 1) / ALIGN * ALIGN);
+        m_options.queue_depth = std::max(1, options.queue_depth);
+        m_options.submit_batch = std::min(std::max(1, options.submit_batch), m_options.queue_depth);
+        m_path = path;
+        m_stats = Stats();
+        m_offset = 0;
+        m_pending = 0;
+
+#ifdef _WIN32
+        m_file = std::fopen(path.c_str(), "wb");
+        if (!m_file) throw std::runtime_error("BlockWriter: cannot open '" + path + "'");
+        m_options.direct = false;
+        m_options.use_io_uring = false;
+#else
+        const int flags = O_WRONLY | O_CREAT | O_TRUNC;
+        m_fd = -1;
+#ifdef O_DIRECT
+        if (m_options.direct) m_fd = ::open(path.c_str(), flags | O_DIRECT, 0644);
+#endif
+        if (m_fd < 0) {
+            m_options.direct = false; // e.g. tmpfs rejects O_DIRECT
+            m_fd = ::open(path.c_str(), flags, 0644);
+        }
+        if (m_fd < 0) throw std::runtime_error("BlockWriter: cannot open '" + path + "'");
+#endif
+
+        m_blocks.assign(static_cast<size_t>(m_options.queue_depth), Block());
+        for (Block& b : m_blocks) b.data = allocate(m_options.block_size);
+#ifdef CIV_HAVE_IO_URING
+        if (m_options.use_io_uring && !m_ring.setup(static_cast<unsigned>(m_options.queue_depth), m_blocks, m_options.block_size)) {
+            m_options.use_io_uring = false;
+        }
+#else
+        m_options.use_io_uring = false;
+#endif
+        m_current = 0;
+        m_buf.reset(m_blocks[0].data, m_options.block_size);
+    }
+
+    bool is_open() const { return !m_blocks.empty(); }
+    const std::string& path() const { return m_path; }
+    const Stats& stats() const { return m_stats; }
+    size_t block_size() const { return m_options.block_size; }
+    bool direct() const { return m_options.direct; }
+
+    // Backend actually in use after open()
+    const char* backend() const {
+        if (m_options.use_io_uring) return m_options.direct ? "io_uring + O_DIRECT" : "io_uring";
+#ifdef _WIN32
+        return "fwrite";
+#else
+        return m_options.direct ? "pwrite + O_DIRECT" : "pwrite";
+#endif
+    }
+
+    // Formatted output; shares the blocks with write()
+    std::ostream& stream() { return m_stream; }
+
+    void write(const void* data, size_t bytes) {
+        const char* p = static_cast<const char*>(data);
+        while (bytes > 0) {
+            if (m_buf.room() == 0) next_block();
+            const size_t n = std::min(bytes, m_buf.room());
+            m_buf.append(p, n);
+            p += n;
+            bytes -= n;
+        }
+    }
+
+    // Writes everything handed over so far and closes the file
+    void close() {
+        if (m_blocks.empty()) return;
+        m_stream.flush();
+        const size_t tail = m_buf.used();
+        if (tail > 0) {
+            // O_DIRECT needs whole pages; the padding is truncated below
+            const size_t padded = m_options.direct ? (tail + ALIGN - 1) / ALIGN * ALIGN : tail;
+            if (padded > tail) std::memset(m_blocks[m_current].data + tail, 0, padded - tail);
+            submit(m_current, padded, tail);
+        }
+        wait_all();
+#ifdef CIV_HAVE_IO_URING
+        if (m_options.use_io_uring) m_ring.teardown();
+#endif
+#ifdef _WIN32
+        std::fclose(m_file);
+        m_file = nullptr;
+#else
+        if (m_options.direct && ftruncate(m_fd, static_cast<off_t>(m_stats.bytes)) != 0) m_failed = true;
+        ::close(m_fd);
+        m_fd = -1;
+#endif
+        for (Block& b : m_blocks) release(b.data);
+        m_blocks.clear();
+        m_buf.reset(nullptr, 0);
+        if (m_failed) {
+            m_failed = false;
+            throw std::runtime_error("BlockWriter: write to '" + m_path + "' failed");
+        }
+    }
+
+private:
+    struct Block {
+        char* data = nullptr;
+        bool in_flight = false;
+        size_t length = 0;   // bytes submitted (padded under O_DIRECT)
+        uint64_t offset = 0;
+    };
+
+    // Put area over the current block
+    class Buffer : public std::streambuf {
+    public:
+        BlockWriter* owner = nullptr;
+        void reset(char* data, size_t size) { setp(data, data + size); }
+        size_t used() const { return static_cast<size_t>(pptr() - pbase()); }
+        size_t room() const { return static_cast<size_t>(epptr() - pptr()); }
+        void append(const char* p, size_t n) {
+            std::memcpy(pptr(), p, n);
+            pbump(static_cast<int>(n));
+        }
+
+    protected:
+        int_type overflow(int_type c) override {
+            owner->next_block();
+            if (!traits_type::eq_int_type(c, traits_type::eof())) {
+                *pptr() = traits_type::to_char_type(c);
+                pbump(1);
+            }
+            return traits_type::not_eof(c);
+        }
+        std::streamsize xsputn(const char* s, std::streamsize n) override {
+            owner->write(s, static_cast<size_t>(n));
+            return n;
+        }
+    };
+
+#ifdef CIV_HAVE_IO_URING
+    // Minimal io_uring over raw syscalls (no liburing dependency)
+    struct Ring {
+        int fd = -1;
+        unsigned entries = 0;
+        void* sq_ptr = nullptr;
+        void* cq_ptr = nullptr;
+        size_t sq_bytes = 0, cq_bytes = 0;
+        io_uring_sqe* sqes = nullptr;
+        size_t sqes_bytes = 0;
+        unsigned *sq_tail = nullptr, *sq_mask = nullptr, *sq_array = nullptr;
+        unsigned *cq_head = nullptr, *cq_tail = nullptr, *cq_mask = nullptr;
+        io_uring_cqe* cqes = nullptr;
+
+        bool setup(unsigned depth, const std::vector<Block>& blocks, size_t block_size) {
+            io_uring_params p{};
+            fd = static_cast<int>(syscall(__NR_io_uring_setup, depth, &p));
+            if (fd < 0) return false;
+            entries = p.sq_entries;
+            sq_bytes = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+            cq_bytes = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+            const bool single = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+            if (single) sq_bytes = cq_bytes = std::max(sq_bytes, cq_bytes);
+            sq_ptr = mmap(nullptr, sq_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+            if (sq_ptr == MAP_FAILED) { sq_ptr = nullptr; teardown(); return false; }
+            cq_ptr = single ? sq_ptr
+                : mmap(nullptr, cq_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+            if (cq_ptr == MAP_FAILED) { cq_ptr = nullptr; teardown(); return false; }
+            sqes_bytes = p.sq_entries * sizeof(io_uring_sqe);
+            void* s = mmap(nullptr, sqes_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+            if (s == MAP_FAILED) { teardown(); return false; }
+            sqes = static_cast<io_uring_sqe*>(s);
+
+            char* sq = static_cast<char*>(sq_ptr);
+            char* cq = static_cast<char*>(cq_ptr);
+            sq_tail = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+            sq_mask = reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+            sq_array = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+            cq_head = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+            cq_tail = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+            cq_mask = reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+            cqes = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+
+            std::vector<iovec> iov(blocks.size());
+            for (size_t k = 0; k < blocks.size(); ++k) iov[k] = { blocks[k].data, block_size };
+            if (syscall(__NR_io_uring_register, fd, IORING_REGISTER_BUFFERS, iov.data(), static_cast<unsigned>(iov.size())) < 0) {
+                teardown();
+                return false;
+            }
+            return true;
+        }
+
+        void teardown() {
+            if (sqes) munmap(sqes, sqes_bytes);
+            if (cq_ptr && cq_ptr != sq_ptr) munmap(cq_ptr, cq_bytes);
+            if (sq_ptr) munmap(sq_ptr, sq_bytes);
+            if (fd >= 0) ::close(fd);
+            *this = Ring();
+        }
+
+        // Queues one WRITE_FIXED (submitted by the next enter())
+        void queue_write(int file, int buf_index, const char* data, unsigned length, uint64_t offset) {
+            const unsigned tail = *sq_tail;
+            const unsigned index = tail & *sq_mask;
+            io_uring_sqe& sqe = sqes[index];
+            std::memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = IORING_OP_WRITE_FIXED;
+            sqe.fd = file;
+            sqe.addr = reinterpret_cast<uint64_t>(data);
+            sqe.len = length;
+            sqe.off = offset;
+            sqe.buf_index = static_cast<uint16_t>(buf_index);
+            sqe.user_data = static_cast<uint64_t>(buf_index);
+            sq_array[index] = index;
+            __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+        }
+
+        int enter(unsigned submit, unsigned wait) {
+            return static_cast<int>(syscall(__NR_io_uring_enter, fd, submit, wait, wait ? IORING_ENTER_GETEVENTS : 0u, nullptr, 0));
+        }
+
+        // Pops one completion; false when the queue is empty
+        bool pop(uint64_t& user_data, int& result) {
+            const unsigned head = *cq_head;
+            if (head == __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE)) return false;
+            const io_uring_cqe& cqe = cqes[head & *cq_mask];
+            user_data = cqe.user_data;
+            result = cqe.res;
+            __atomic_store_n(cq_head, head + 1, __ATOMIC_RELEASE);
+            return true;
+        }
+    };
+    Ring m_ring;
+#endif
+
+    Options m_options;
+    std::string m_path;
+    Stats m_stats;
+    std::vector<Block> m_blocks;
+    int m_current = 0;
+    uint64_t m_offset = 0; // file offset of the current block
+    unsigned m_pending = 0; // queued io_uring writes not yet submitted
+    bool m_failed = false;
+    Buffer m_buf;
+    std::ostream m_stream;
+#ifdef _WIN32
+    std::FILE* m_file = nullptr;
+#else
+    int m_fd = -1;
+#endif
+
+    static char* allocate(size_t bytes) {
+#ifdef _WIN32
+        void* p = _aligned_malloc(bytes, ALIGN);
+#else
+        void* p = nullptr;
+        if (posix_memalign(&p, ALIGN, bytes) != 0) p = nullptr;
+#endif
+        if (!p) throw std::bad_alloc();
+        return static_cast<char*>(p);
+    }
+    static void release(char* p) {
+#ifdef _WIN32
+        _aligned_free(p);
+#else
+        std::free(p);
+#endif
+    }
+
+    // Hands the full current block over and makes the next one current
+    void next_block() {
+        submit(m_current, m_options.block_size, m_options.block_size);
+        m_current = (m_current + 1) % static_cast<int>(m_blocks.size());
+        while (m_blocks[m_current].in_flight) reap(true);
+        m_buf.reset(m_blocks[m_current].data, m_options.block_size);
+    }
+
+    // 'length' bytes go to disk, of which 'logical' count as file content
+    void submit(int k, size_t length, size_t logical) {
+        Block& b = m_blocks[k];
+        b.length = length;
+        b.offset = m_offset;
+        m_offset += length;
+        m_stats.bytes += static_cast<long long>(logical);
+        m_stats.blocks++;
+#ifdef CIV_HAVE_IO_URING
+        if (m_options.use_io_uring) {
+            b.in_flight = true;
+            m_ring.queue_write(m_fd, k, b.data, static_cast<unsigned>(length), b.offset);
+            if (++m_pending >= static_cast<unsigned>(m_options.submit_batch)) enter(0);
+            return;
+        }
+#endif
+        write_at(b.data, length, b.offset);
+    }
+
+    // Synchronous write of a whole block (also finishes short io_uring writes)
+    void write_at(const char* data, size_t length, uint64_t offset) {
+#ifdef _WIN32
+        (void)offset;
+        m_stats.syscalls++;
+        if (std::fwrite(data, 1, length, m_file) != length) m_failed = true;
+#else
+        while (length > 0) {
+            m_stats.syscalls++;
+            const ssize_t n = pwrite(m_fd, data, length, static_cast<off_t>(offset));
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) {
+                m_failed = true;
+                return;
+            }
+            data += n;
+            offset += static_cast<uint64_t>(n);
+            length -= static_cast<size_t>(n);
+        }
+#endif
+    }
+
+    // Collects completed writes; 'block' waits for at least one
+    void reap(bool block) {
+#ifdef CIV_HAVE_IO_URING
+        if (!m_options.use_io_uring) return;
+        bool got = false;
+        while (true) {
+            uint64_t k = 0;
+            int result = 0;
+            if (!m_ring.pop(k, result)) {
+                if (got || !block) return;
+                // Submits whatever is still queued and waits in one call
+                if (!enter(1)) return;
+                continue;
+            }
+            got = true;
+            Block& b = m_blocks[k];
+            b.in_flight = false;
+            // An interrupted or would-block write is not an I/O error
+            if (result == -EINTR || result == -EAGAIN) write_at(b.data, b.length, b.offset);
+            else if (result < 0) m_failed = true;
+            else if (static_cast<size_t>(result) < b.length) {
+                write_at(b.data + result, b.length - result, b.offset + result);
+            }
+        }
+#else
+        (void)block;
+#endif
+    }
+
+#ifdef CIV_HAVE_IO_URING
+    // Submits the queued writes and, with 'wait', waits for one completion.
+    // EINTR, EAGAIN and EBUSY (completion queue full) submit nothing and are
+    // retried by the caller's next pop/enter round; blocks stay in flight
+    // until their completion arrives. Any other error is fatal: the ring is
+    // torn down, which finishes or cancels what the kernel holds, and later
+    // blocks go through pwrite. Returns false only then.
+    bool enter(unsigned wait) {
+        m_stats.syscalls++;
+        const int entered = m_ring.enter(m_pending, wait);
+        if (entered >= 0) {
+            m_pending -= std::min(m_pending, static_cast<unsigned>(entered));
+            return true;
+        }
+        if (errno == EINTR || errno == EAGAIN || errno == EBUSY) return true;
+        m_failed = true;
+        m_ring.teardown();
+        m_options.use_io_uring = false;
+        m_pending = 0;
+        for (Block& b : m_blocks) b.in_flight = false;
+        return false;
+    }
+#endif
+
+    void wait_all() {
+        for (const Block& b : m_blocks) {
+            while (b.in_flight) reap(true);
+        }
+    }
+};
@@ -1,6 +1,15 @@
 #pragma once
+#include "EvaluationCostModel.h"
+#include "EvaluationRecording.h"
 #include "Individual.h"
-
+#include "LicensePool.h"
+#include "LinearConstraints.h"
+#include "LshIndex.h"
+#include "MappedPopulation.h"
+#include "TaskRuntime.h"
+
+#include <array>
+#include <chrono>
 #include <cmath>
 #include <limits>
 #include <fstream>
@@ -10,12 +19,63 @@
 #include <random>
 #include <algorithm>
 #include <functional> // Required for std::function
+#include <memory>
+#include <sstream>
+#include <stdexcept>
 
 class Civilization {
 public:
+    // Counters for nearest-leader / nearest-super-leader queries
+    struct NearestSearchStats {
+        long long queries = 0;
+        long long approximate = 0;      // answered by the LSH index
+        long long exact_fallbacks = 0;  // LSH enabled but no bucket matched, or recall below target at max tables
+        long long distance_evals = 0;   // point-to-target distances computed
+        long long probes = 0;           // queries re-checked exactly to measure recall
+        long long probe_hits = 0;       // ... where LSH returned the true nearest
+    };
+
+    // Distance work of the hub-center clustering (Step 2), not counting
+    // the merging of small societies
+    struct ClusteringStats {
+        long long distance_evals = 0; // distances computed
+        long long reused = 0;         // point-to-own-hub and hub-to-hub distances taken from the cache
+        long long pruned = 0;         // point-to-new-hub distances ruled out by the triangle inequality
+    };
+
     // Define generic types for our problem functions
     using ObjFunc = std::function<double(const Individual&)>;
     using ConFunc = std::function<std::vector<double>(const Individual&)>;
+    // Writes the violations into an existing vector (resized as needed), so
+    // evaluation reuses each individual's storage instead of allocating
+    using ConWriteFunc = std::function<void(const Individual&, std::vector<double>&)>;
+    // Evaluates a whole batch at once (e.g. on a remote service), filling in
+    // objective_value and constraint_violations of every individual
+    using BatchEvalFunc = std::function<void(const std::vector<Individual*>&)>;
+
+    // Regions of the Information Acquisition Operator (Figure 2)
+    enum Region { BELOW_MIN = 0, BETWEEN = 1, ABOVE_MAX = 2, NUM_REGIONS = 3 };
+    using RegionProbs = std::array<double, NUM_REGIONS>;
+
+    // The paper's fixed 25% / 50% / 25% split
+    static constexpr RegionProbs FIXED_REGION_PROBS = { 0.25, 0.50, 0.25 };
+
+    // What happens to a candidate that violates the cheap linear constraints
+    enum RepairMode { REPAIR_NONE = 0, REPAIR_PROJECT, REPAIR_REJECT };
+
+    // Counters of the cheap-constraint check before evaluation
+    struct RepairStats {
+        long long checked = 0;    // candidates checked
+        long long projected = 0;  // moved into the constraints, then evaluated
+        long long rejected = 0;   // move undone, not evaluated (REPAIR_REJECT)
+        long long unrepaired = 0; // projection failed; evaluated as they were
+    };
+
+    // Counters of the evaluation bandit
+    struct BanditStats {
+        long long moved = 0;  // followers moved in Step 4 (evaluated at the next step)
+        long long frozen = 0; // followers kept in place, no evaluation spent
+    };
 
 private:
     std::vector<Individual> population;
@@ -43,9 +103,184 @@ private:
     // --- GENERIC PROBLEM LOGIC ---
     ObjFunc m_objective_fn;
     ConFunc m_constraint_fn;
+    ConWriteFunc m_constraint_writer; // when set, used instead of m_constraint_fn
+    BatchEvalFunc m_batch_fn; // when set, used instead of the two functors above
 
     size_t expected_constraint_dim = static_cast<size_t>(-1);
 
+    // Number of objective/constraint evaluations performed by this civilization
+    long long m_evaluations = 0;
+
+    // Best individual ever evaluated (positions move after evaluation, so the
+    // current population alone cannot answer this between steps)
+    Individual best_ever = Individual(0);
+    bool m_has_best_ever = false;
+
+    bool m_verbose = true; // print progress messages to std::cout
+
+    // --- Parallelism (all layers share TaskRuntime::instance()) ---
+    bool m_parallel_evaluation = false; // evaluate individuals concurrently
+    bool m_parallel_societies = false;  // rank/select leaders of societies concurrently
+
+    // --- Self-adaptive operator probabilities (optional) ---
+    // Societies are re-formed every step, so the learnt state lives on the
+    // individuals: each carries the region quality of the society it last
+    // belonged to, and a new society starts from the mean of its members.
+    bool m_adaptive_operators = false;
+    double m_adaptive_min_prob = 0.1;  // lower bound on each region's probability
+    double m_adaptive_rate = 0.3;      // weight of the latest success rate
+    std::vector<RegionProbs> region_quality;                 // per individual
+    std::vector<std::array<int, NUM_REGIONS>> region_uses;   // per individual: variables moved into each region last move
+    std::vector<RegionProbs> society_probs;                  // per society: probabilities used this step
+
+    // --- Epsilon-constrained feasibility schedule (optional) ---
+    // Individuals whose violation sum is <= epsilon count as feasible in
+    // ranking and leader filtering. Epsilon shrinks from epsilon0 to zero over
+    // the first m_epsilon_steps time steps. Reported and kept solutions
+    // (get_best_solution, best_ever) are always judged by FEAS_EPS.
+    bool m_epsilon_schedule = false;
+    double m_epsilon0 = -1.0;       // < 0: taken from the initial population
+    double m_epsilon0_setting = -1.0; // as passed to set_epsilon_schedule() (reseed() restores it)
+    double m_epsilon_quantile = 0.2;
+    int m_epsilon_steps = 0;        // Tc: steps until epsilon reaches zero
+    double m_epsilon_exponent = 2.0;
+    double m_epsilon = 0.0;         // current level
+    int m_time_step = 0;            // completed calls to identify_leaders()
+
+    // --- Cost-aware evaluation scheduling (optional) ---
+    // Evaluations are timed, each candidate's cost is predicted from recent
+    // history and the batch is dispatched longest-predicted-first.
+    bool m_cost_aware = false;
+    EvaluationCostModel cost_model;
+    std::vector<double> m_eval_seconds;   // last batch: measured, per individual
+    std::vector<double> m_eval_predicted; // last batch: predicted, per individual
+    std::vector<int> m_eval_order;        // last batch: dispatch order
+
+    // --- Approximate nearest-leader search (optional) ---
+    // For large n and large leader sets the nearest-leader queries of Steps 4
+    // and 7 go through a p-stable LSH index. The number of tables in use is
+    // adapted so that the recall measured on sampled exact re-checks stays at
+    // or above the target. If it is still below the target with every table
+    // in use, queries are answered exactly (and still probed) until it recovers.
+    bool m_lsh = false;
+    double m_lsh_recall_target = 0.9;
+    int m_lsh_min_targets = 64;   // smaller target sets are searched exactly
+    int m_lsh_min_dims = 20;      // lower-dimensional problems are searched exactly
+    double m_lsh_width_scale = 0.5;
+    int m_lsh_tables = 4;
+    int m_lsh_window_probes = 0;
+    int m_lsh_window_hits = 0;
+    bool m_lsh_below_target = false; // last window: recall < target at max tables
+    LshIndex lsh_index;
+    std::mt19937 lsh_rng;
+    NearestSearchStats nearest_stats;
+    ClusteringStats clustering_stats;
+
+    // --- Out-of-core population (optional) ---
+    // With a storage path, the positions, objectives, ranks and violations
+    // live only in a memory-mapped file (MappedPopulation) and 'population'
+    // stays empty. Every pass reads and writes the mapped columns in index
+    // order; evaluation hydrates one window of rows at a time into
+    // eval_window and writes the results back, and advise() hints let the
+    // OS read ahead and drop the rows already done with. Passes that revisit
+    // every row (clustering, nearest-leader search) leave the file pages to
+    // the OS's reclaim, which unlike heap memory can simply drop them.
+    std::string m_storage_path;
+    std::unique_ptr<MappedPopulation> storage; // open while the population is out of core
+    std::vector<Individual> eval_window;
+
+    // --- Checkpoints (optional) ---
+    std::string m_checkpoint_path; // step() saves one here every m_checkpoint_every steps
+    int m_checkpoint_every = 1;
+
+    // --- Bounded leader sets (optional) ---
+    // 0 keeps the paper's selection; k > 0 keeps at most the k best leaders
+    // per society and k super leaders, so the global phase stays bounded.
+    int m_max_leaders = 0;
+    int m_max_super_leaders = 0;
+    std::vector<double> cap_crowding; // cap_leaders() scratch, per leader
+    std::vector<size_t> cap_order;
+
+    // --- Society size limits (optional) ---
+    // 0 keeps the paper's clustering. max_hubs > 0 stops adding hubs once
+    // there are that many societies; min_society > 1 dissolves societies
+    // smaller than that, smallest first, each member joining its nearest
+    // remaining hub. Both bound the number of local leaders, and so the
+    // global society, by a parameter instead of by the random geometry.
+    int m_max_hubs = 0;
+    int m_min_society = 0;
+    std::vector<int> society_size;  // per hub, while merging
+    std::vector<int> hub_renumber;  // old society id -> compacted id
+
+    // --- Clustering caches ---
+    std::vector<double> own_hub_distance; // per individual: distance to its hub
+    std::vector<double> hub_pairs;        // d(hubs[i], hubs[j]) for i < j at j*(j-1)/2 + i
+
+    // --- License-token budget (optional) ---
+    // Every objective/constraint evaluation, or every call of the batch
+    // function, holds one token of a pool that may be shared with other
+    // civilizations (and, via its token directory, with other processes).
+    std::shared_ptr<LicensePool> license_pool;
+    int m_license_client = -1;
+
+    // --- Influence log (optional) ---
+    // influence[i] is the agent that i moved toward in the current step: its
+    // nearest leader (Step 4) or, for a leader, its nearest super leader
+    // (Step 7); -1 when i did not move.
+    bool m_track_influence = false;
+    std::vector<int32_t> influence;
+
+    // --- Cheap-constraint repair (optional) ---
+    // Before evaluation, candidates that violate the problem's cheap linear
+    // constraints are projected into them or, with REPAIR_REJECT, put back at
+    // their last evaluated position (keeping its values), so no evaluation is
+    // spent on a point known to be infeasible. Individuals without an
+    // evaluated position (the initial population, seeded points) are
+    // projected in both modes.
+    RepairMode m_repair = REPAIR_NONE;
+    LinearConstraints linear_constraints;
+    RepairStats repair_stats;
+    std::vector<double> evaluated_positions; // REPAIR_REJECT: last evaluated variables, n per individual
+    std::vector<char> has_evaluated_position;
+    std::vector<int> eval_list;              // individuals evaluated this step
+
+    // --- Evaluation recording (optional) ---
+    // Every evaluated individual is appended with its results, in
+    // evaluation-list order, for EvaluationReplay.
+    std::shared_ptr<EvaluationRecorder> recorder;
+
+    // --- Evaluation bandit (optional) ---
+    // Societies are the arms. Each step only budget_fraction of the
+    // followers move: every society gets min_share of its followers, the
+    // rest of the budget goes to societies in proportion to their recent
+    // improvement rate. Unmoved individuals keep their position and values
+    // and are not re-evaluated. Societies are re-formed every step, so the
+    // rate lives on the individuals (smoothed over their evaluated moves)
+    // and a society's rate is the mean over its members.
+    bool m_bandit = false;
+    double m_bandit_budget = 0.5;
+    double m_bandit_min_share = 0.1;
+    double m_bandit_decay = 0.7;        // weight of the past in each improvement rate
+    BanditStats bandit_stats;
+    std::vector<double> bandit_gain;    // per individual: improvement rate
+    std::vector<char> moved;            // per individual: moved since its last evaluation
+    std::vector<char> move_chosen;      // per individual: may move in Step 4 of this step
+    std::vector<int> bandit_quota;      // per society: followers that move this step
+    std::vector<double> bandit_score;   // per society: mean improvement rate
+    std::vector<int> bandit_order;      // societies by score, best first
+    std::vector<int> bandit_pool;       // followers of one society
+    std::vector<std::pair<double, double>> bandit_prev; // per evaluated individual: objective, violation before
+
+    // --- Per-step scratch ---
+    // Rebuilt every step but never shrunk, so once their capacities cover
+    // the population (see reserve_step_buffers()) a step allocates nothing.
+    std::vector<std::vector<int>> societies;      // members of each society, this step
+    std::vector<std::vector<int>> spare_lists;    // emptied lists kept for their capacity
+    std::vector<double> prev_objective, prev_violation; // adaptive operator: values before the last move
+    std::vector<int> movers;                      // Step 7: leaders that are not super leaders
+    std::vector<Individual*> eval_batch;
+    double m_step_seconds = 0.0;      // duration of the last step()
+    double m_step_seconds_avg = 0.0;  // moving average of step() durations
 
 public:
     // Constructor updated to accept generic functors
@@ -64,21 +299,499 @@ public:
         rng.seed(seed);
     }
 
+    // Objective/constraint functors must be thread-safe when evaluation is parallel.
+    void set_parallel_evaluation(bool enabled) { m_parallel_evaluation = enabled; }
+    void set_parallel_societies(bool enabled) { m_parallel_societies = enabled; }
+
+    // Hands the whole population to 'fn' in one call per evaluation (an empty
+    // function restores per-individual evaluation)
+    void set_batch_evaluator(BatchEvalFunc fn) { m_batch_fn = std::move(fn); }
+
+    // Switches to another problem over the same variables and bounds (e.g.
+    // the next instance of a parameter sweep). Values of the old problem are
+    // dropped: the best-ever record restarts and the population is
+    // re-evaluated at the next step. Clears the constraint writer.
+    void set_problem(ObjFunc objective, ConFunc constraints) {
+        m_objective_fn = std::move(objective);
+        m_constraint_fn = std::move(constraints);
+        m_constraint_writer = nullptr;
+        expected_constraint_dim = static_cast<size_t>(-1);
+        m_has_best_ever = false;
+    }
+
+    // Checks every candidate against 'constraints' (cheap a.x <= b, e.g.
+    // LinearConstraints from WeldedBeamDesign::linear_constraints()) before
+    // evaluation and repairs violators as 'mode' says; REPAIR_NONE turns it off
+    void set_repair(RepairMode mode, LinearConstraints constraints = LinearConstraints()) {
+        if (mode != REPAIR_NONE && constraints.dimension() != n_variables) {
+            throw std::invalid_argument("set_repair(): constraints must cover all " + std::to_string(n_variables) + " variables");
+        }
+        m_repair = mode;
+        linear_constraints = std::move(constraints);
+        has_evaluated_position.clear();
+    }
+    RepairMode repair_mode() const { return m_repair; }
+    const RepairStats& get_repair_stats() const { return repair_stats; }
+
+    // Moves only 'budget_fraction' of the followers per step, shared out
+    // across societies by their recent improvement rate with at least
+    // 'min_share' of each society's followers; followers left in place are
+    // not re-evaluated. 'decay' is the weight of the past in the rates.
+    void set_evaluation_bandit(bool enabled, double budget_fraction = 0.5, double min_share = 0.1, double decay = 0.7) {
+        if (enabled && (budget_fraction <= 0.0 || budget_fraction > 1.0)) {
+            throw std::invalid_argument("set_evaluation_bandit(): budget_fraction must be in (0, 1]");
+        }
+        if (enabled && (min_share < 0.0 || min_share > budget_fraction)) {
+            throw std::invalid_argument("set_evaluation_bandit(): min_share must be in [0, budget_fraction]");
+        }
+        if (decay < 0.0 || decay >= 1.0) throw std::invalid_argument("set_evaluation_bandit(): decay must be in [0, 1)");
+        m_bandit = enabled;
+        m_bandit_budget = budget_fraction;
+        m_bandit_min_share = min_share;
+        m_bandit_decay = decay;
+        moved.clear();
+    }
+    bool evaluation_bandit() const { return m_bandit; }
+
+    // Appends every evaluation of this civilization to 'rec' (nullptr: off);
+    // several civilizations may share one recorder
+    void set_evaluation_recorder(std::shared_ptr<EvaluationRecorder> rec) { recorder = std::move(rec); }
+    const BanditStats& get_bandit_stats() const { return bandit_stats; }
+
+    // Replaces the constraint functor with one that writes into the
+    // individual's violation vector (an empty function restores it)
+    void set_constraint_writer(ConWriteFunc fn) { m_constraint_writer = std::move(fn); }
+
+    // Caps leaders per society at 'per_society' and super leaders at
+    // 'super_leaders' (< 0: same as per_society); 0 means no cap. Leaders are
+    // kept best first (is_better_solution); among equal solutions the one
+    // farthest from the other candidates wins.
+    void set_max_leaders(int per_society, int super_leaders = -1) {
+        m_max_leaders = std::max(0, per_society);
+        m_max_super_leaders = super_leaders < 0 ? m_max_leaders : super_leaders;
+    }
+
+    // Records which agent every agent moved toward (see get_influence());
+    // log_state() then appends it as an InfluencedBy column
+    void set_influence_tracking(bool enabled) {
+        m_track_influence = enabled;
+        if (!enabled) influence.clear();
+    }
+    bool influence_tracking() const { return m_track_influence; }
+    const std::vector<int32_t>& get_influence() const { return influence; }
+
+    // Caps the societies formed per step at 'max_hubs' (0: no cap, else at
+    // least 2) and merges societies of fewer than 'min_size' members into
+    // their neighbours (0 or 1: no merging)
+    void set_society_limits(int max_hubs, int min_size = 0) {
+        if (max_hubs < 0 || max_hubs == 1) throw std::invalid_argument("set_society_limits(): max_hubs must be 0 or at least 2");
+        m_max_hubs = max_hubs;
+        m_min_society = std::max(0, min_size);
+    }
+
+    // Society of every individual in the current step (-1 before clustering)
+    const std::vector<int>& get_assignments() const { return assignments; }
+    const std::vector<int>& get_hubs() const { return hubs; } // hub individual of every society
+    const std::vector<int>& get_global_society() const { return global_society; }
+    const std::vector<std::vector<int>>& get_society_leaders() const { return society_leaders; }
+    const std::vector<int>& get_super_leaders() const { return super_leaders; }
+
+    // Limits concurrent evaluations to the tokens of 'pool' (nullptr: no limit).
+    // 'label' names this civilization in the pool's per-client statistics.
+    // A batch function call counts as one evaluation. An evaluation waiting
+    // for a token blocks its TaskRuntime thread (it sleeps, it does not run
+    // other tasks), so runs sharing a pool in one process want more runtime
+    // threads than tokens (TaskRuntime::set_max_threads); the waits need no core.
+    void set_license_pool(std::shared_ptr<LicensePool> pool, const std::string& label = "run") {
+        license_pool = std::move(pool);
+        m_license_client = license_pool ? license_pool->register_client(label) : -1;
+    }
+
+    // Seconds this civilization's evaluations spent waiting for license tokens
+    double license_wait_seconds() const {
+        return license_pool ? license_pool->client_stats(m_license_client).wait_seconds : 0.0;
+    }
+
+    long long evaluations() const { return m_evaluations; }
+
+    void set_verbose(bool verbose) { m_verbose = verbose; }
+
+    // Lets each society learn its own region probabilities from which regions
+    // produced improvements; every probability stays within [min_prob, 1 - 2*min_prob].
+    // learning_rate is the weight of the latest success rate, in (0, 1].
+    void set_adaptive_operators(bool enabled, double min_prob = 0.1, double learning_rate = 0.3) {
+        if (min_prob < 0.0 || min_prob > 1.0 / NUM_REGIONS) {
+            throw std::invalid_argument("set_adaptive_operators(): min_prob must be in [0, 1/3]");
+        }
+        if (!(learning_rate > 0.0 && learning_rate <= 1.0)) {
+            throw std::invalid_argument("set_adaptive_operators(): learning_rate must be in (0, 1]");
+        }
+        m_adaptive_operators = enabled;
+        m_adaptive_min_prob = min_prob;
+        m_adaptive_rate = learning_rate;
+    }
+
+    // epsilon(t) = epsilon0 * (1 - t / control_steps)^exponent for t < control_steps, 0 afterwards.
+    // A negative epsilon0 uses the violation sum at the given quantile of the
+    // first evaluated population.
+    void set_epsilon_schedule(bool enabled, int control_steps, double epsilon0 = -1.0,
+        double exponent = 2.0, double quantile = 0.2) {
+        if (enabled && control_steps <= 0) {
+            throw std::invalid_argument("set_epsilon_schedule(): control_steps must be positive");
+        }
+        m_epsilon_schedule = enabled;
+        m_epsilon_steps = control_steps;
+        m_epsilon0 = m_epsilon0_setting = epsilon0;
+        m_epsilon_exponent = exponent;
+        m_epsilon_quantile = std::min(std::max(quantile, 0.0), 1.0);
+        m_epsilon = 0.0;
+    }
+
+    // kind == EvaluationCostModel::NONE turns cost-aware scheduling off
+    void set_cost_aware_scheduling(EvaluationCostModel::Kind kind, int history = 256) {
+        m_cost_aware = (kind != EvaluationCostModel::NONE);
+        cost_model = EvaluationCostModel(kind, lower_bounds, upper_bounds, history);
+    }
+
+    // Approximate nearest-leader search via LSH when n >= min_dims and the
+    // leader set has at least min_targets members; exact search otherwise.
+    void set_approximate_nearest_search(bool enabled, double recall_target = 0.9,
+        int min_targets = 64, int min_dims = 20, int max_tables = 32, int hashes_per_table = 4) {
+        m_lsh = enabled;
+        m_lsh_recall_target = recall_target;
+        m_lsh_min_targets = min_targets;
+        m_lsh_min_dims = min_dims;
+        m_lsh_tables = std::min(4, max_tables);
+        m_lsh_window_probes = m_lsh_window_hits = 0;
+        m_lsh_below_target = false;
+        if (enabled) {
+            lsh_index = LshIndex(n_variables, max_tables, hashes_per_table, static_cast<unsigned>(rng()));
+            lsh_rng.seed(static_cast<unsigned>(rng()));
+        }
+    }
+
+    const NearestSearchStats& nearest_search_stats() const { return nearest_stats; }
+    void reset_nearest_search_stats() { nearest_stats = NearestSearchStats(); }
+    const ClusteringStats& clustering_search_stats() const { return clustering_stats; }
+    void reset_clustering_stats() { clustering_stats = ClusteringStats(); }
+    int approximate_search_tables() const { return m_lsh_tables; }
+    // True while LSH misses the recall target with every table in use and
+    // the queries are answered exactly
+    bool approximate_search_below_target() const { return m_lsh_below_target; }
+
+    // Keeps the population out of core: from the next initialize(), reseed()
+    // or restore_checkpoint() on, positions, objectives, ranks and violations
+    // live only in a memory-mapped file at 'path' (overwritten), paged in and
+    // out by the OS. An empty path keeps the population in memory again.
+    // Out of core, get_population() is not available (see get_individual())
+    // and neither is REPAIR_REJECT, which keeps a second copy of every position.
+    void set_population_storage(const std::string& path) { m_storage_path = path; }
+    bool population_out_of_core() const { return storage != nullptr; }
+
+    // step() saves a checkpoint to 'path' after every 'every' steps (see
+    // save_checkpoint()); an empty path turns this off
+    void set_checkpoint(const std::string& path, int every = 1) {
+        if (every < 1) throw std::invalid_argument("set_checkpoint(): every must be positive");
+        m_checkpoint_path = path;
+        m_checkpoint_every = every;
+    }
+
+    // Writes the population, best-ever individual, counters and RNG state to
+    // 'path' for restore_checkpoint(). The file is replaced atomically
+    // (temporary file, fsync, rename), so a crash keeps the previous
+    // checkpoint. Out of core the mapped file itself is copied (a reflink
+    // where the file system supports it). Adaptive operator, cost-model and
+    // LSH state are not part of the checkpoint.
+    void save_checkpoint(const std::string& path) {
+        if (storage) {
+            write_checkpoint_state(*storage);
+            storage->snapshot(path);
+            return;
+        }
+        if (population.empty()) throw std::logic_error("save_checkpoint(): no population");
+        const std::string tmp = path + ".tmp";
+        {
+            const size_t num_constraints = expected_constraint_dim == static_cast<size_t>(-1) ? 0 : expected_constraint_dim;
+            MappedPopulation file;
+            file.create(tmp, m_pop_size, n_variables, static_cast<int>(num_constraints));
+            const int window = storage_window();
+            for (int first = 0; first < m_pop_size; first += window) {
+                const int count = std::min(window, m_pop_size - first);
+                file.advise(first, count, true);
+                for (int i = first; i < first + count; ++i) write_row(file, i, population[i]);
+                file.advise(first, count, false);
+            }
+            write_checkpoint_state(file);
+            file.flush(true);
+        }
+        MappedPopulation::replace_file(tmp, path);
+    }
+
+    // Loads a checkpoint written by save_checkpoint(); the population size is
+    // taken from the file. With population storage set, the checkpoint is
+    // copied to the storage path and the population stays out of core.
+    void restore_checkpoint(const std::string& path) {
+        auto file = std::make_unique<MappedPopulation>();
+        file->open(path, false);
+        if (file->header().num_variables != n_variables) {
+            throw std::invalid_argument("restore_checkpoint(): variable count mismatch");
+        }
+
+        if (!m_storage_path.empty()) {
+            if (path == m_storage_path) throw std::invalid_argument("restore_checkpoint(): '" + path + "' is the population storage file");
+            file->close();
+            storage.reset();
+            MappedPopulation::copy_file(path, m_storage_path);
+            file->open(m_storage_path);
+            storage = std::move(file);
+            population.clear();
+            population.shrink_to_fit();
+            read_checkpoint_state(*storage);
+            return;
+        }
+
+        const MappedPopulation::Header& h = file->header();
+        storage.reset();
+        population.assign(h.size, Individual(n_variables));
+        const int window = storage_window();
+        for (int first = 0; first < h.size; first += window) {
+            const int count = std::min(window, h.size - first);
+            file->advise(first, count, true);
+            for (int i = first; i < first + count; ++i) read_row(*file, i, population[i]);
+            file->advise(first, count, false);
+        }
+        read_checkpoint_state(*file);
+    }
+
+    // Copy of individual i, in memory or out of core
+    Individual get_individual(int i) const {
+        if (!storage) return population[i];
+        Individual ind(n_variables);
+        read_row(*storage, i, ind);
+        return ind;
+    }
+
+    // Per-batch scheduling data (empty unless cost-aware scheduling is on)
+    const std::vector<double>& last_evaluation_seconds() const { return m_eval_seconds; }
+    const std::vector<double>& last_predicted_seconds() const { return m_eval_predicted; }
+    const std::vector<int>& last_dispatch_order() const { return m_eval_order; }
+
+    // Violation tolerance in effect for the current step (0 unless scheduled)
+    double current_epsilon() const { return m_epsilon; }
+
+    // Region probabilities per society for the current step (empty unless adaptive)
+    const std::vector<RegionProbs>& get_society_region_probs() const { return society_probs; }
+
+    // Starts a new run in place: same problem, options and allocated storage,
+    // fresh state from 'seed'. Equivalent to constructing a new civilization
+    // with 'seed', applying the same set_*() options and calling initialize().
+    // The evaluation-cost history and license client are kept.
+    void reseed(unsigned int seed) {
+        rng.seed(seed);
+        if (m_lsh) {
+            // set_approximate_nearest_search() draws these right after construction
+            lsh_index = LshIndex(n_variables, lsh_index.max_tables(), lsh_index.hashes_per_table(), static_cast<unsigned>(rng()));
+            lsh_rng.seed(static_cast<unsigned>(rng()));
+            m_lsh_tables = std::min(4, lsh_index.max_tables());
+            m_lsh_window_probes = m_lsh_window_hits = 0;
+            m_lsh_below_target = false;
+        }
+        nearest_stats = NearestSearchStats();
+
+        hubs.clear();
+        assignments.clear();
+        resize_lists(society_leaders, 0);
+        global_society.clear();
+        super_leaders.clear();
+        region_quality.clear();
+        region_uses.clear();
+        influence.clear();
+        society_probs.clear();
+        m_eval_seconds.clear();
+        m_eval_predicted.clear();
+        m_eval_order.clear();
+        has_evaluated_position.clear();
+        repair_stats = RepairStats();
+        bandit_stats = BanditStats();
+
+        expected_constraint_dim = static_cast<size_t>(-1);
+        m_evaluations = 0;
+        m_has_best_ever = false;
+        m_epsilon0 = m_epsilon0_setting;
+        m_epsilon = 0.0;
+        m_time_step = 0;
+        m_step_seconds = 0.0;
+        m_step_seconds_avg = 0.0;
+
+        initialize();
+    }
+
     // Corresponds to Section 3.1: Initialization
         void initialize() {
-        population.clear();
-        population.reserve(m_pop_size);
         std::uniform_real_distribution<double> R(0.0, 1.0);
 
-        for (int i = 0; i < m_pop_size; ++i) {
-            Individual ind(n_variables);
+        if (!m_storage_path.empty()) {
+            // Out of core: the same values, written row by row into the file;
+            // the violations column is sized at the first evaluation
+            if (!storage || storage->path() != m_storage_path || storage->header().capacity != m_pop_size) {
+                storage.reset();
+                storage = std::make_unique<MappedPopulation>();
+                storage->create(m_storage_path, m_pop_size, n_variables, 0);
+            }
+            else storage->set_constraints(0);
+            population.clear();
+            population.shrink_to_fit();
+
+            const int window = storage_window();
+            for (int first = 0; first < m_pop_size; first += window) {
+                const int count = std::min(window, m_pop_size - first);
+                storage->advise(first, count, true);
+                for (int i = first; i < first + count; ++i) {
+                    double* x = storage->variables(i);
+                    for (int j = 0; j < n_variables; ++j) {
+                        double r_val = R(rng);
+                        x[j] = lower_bounds[j] + r_val * (upper_bounds[j] - lower_bounds[j]);
+                    }
+                    storage->objective(i) = 0.0;
+                    storage->rank(i) = 0;
+                    storage->society(i) = -1;
+                }
+                storage->advise(first, count, false);
+            }
+        }
+        else {
+            storage.reset();
+            // Existing individuals are overwritten so that a reseed() reuses their storage
+            population.resize(m_pop_size, Individual(n_variables));
+            for (int i = 0; i < m_pop_size; ++i) {
+                Individual& ind = population[i];
+                ind.variables.resize(n_variables);
+                for (int j = 0; j < n_variables; ++j) {
+                    double r_val = R(rng);
+                    ind.variables[j] = lower_bounds[j] + r_val * (upper_bounds[j] - lower_bounds[j]);
+                }
+                ind.constraint_violations.clear();
+                ind.objective_value = 0.0;
+                ind.rank = 0;
+            }
+        }
+        moved.clear();
+        bandit_gain.clear();
+        if (m_verbose) std::cout << "Civilization initialized with " << m_pop_size << " individuals." << std::endl;
+    }
+
+    // Moves the first positions.size() individuals to the given points
+    // (clamped to the bounds), e.g. to start from the final population of a
+    // related problem; they are evaluated at the next step
+    void seed_positions(const std::vector<std::vector<double>>& positions) {
+        const int count = std::min(static_cast<int>(positions.size()), population_count());
+        for (int i = 0; i < count; ++i) {
+            if ((int)positions[i].size() != n_variables) {
+                throw std::invalid_argument("seed_positions(): variable count mismatch");
+            }
+            double* x = position(i);
             for (int j = 0; j < n_variables; ++j) {
-                double r_val = R(rng);
-                ind.variables[j] = lower_bounds[j] + r_val * (upper_bounds[j] - lower_bounds[j]);
+                x[j] = std::min(std::max(positions[i][j], lower_bounds[j]), upper_bounds[j]);
             }
-            population.push_back(ind);
+            if (i < (int)has_evaluated_position.size()) has_evaluated_position[i] = 0;
         }
-        std::cout << "Civilization initialized with " << m_pop_size << " individuals." << std::endl;
+    }
+
+    // Rows per streaming window of the population storage (about 1 MB of variables)
+    int storage_window() const {
+        return std::max(1, static_cast<int>((1u << 20) / (sizeof(double) * std::max(1, n_variables))));
+    }
+
+    // Individuals currently held (0 before initialize())
+    int population_count() const { return storage ? m_pop_size : static_cast<int>(population.size()); }
+
+    // --- Row accessors: individual i in memory or out of core ---
+    double* position(int i) { return storage ? storage->variables(i) : population[i].variables.data(); }
+    const double* position(int i) const { return storage ? storage->variables(i) : population[i].variables.data(); }
+    double objective_at(int i) const { return storage ? storage->objective(i) : population[i].objective_value; }
+    int rank_at(int i) const { return storage ? storage->rank(i) : population[i].rank; }
+    void set_rank(int i, int rank) {
+        if (storage) storage->rank(i) = rank;
+        else population[i].rank = rank;
+    }
+
+    // violation_sum() of individual i
+    double violation_sum_at(int i) const {
+        if (!storage) return violation_sum(population[i]);
+        const double* v = storage->violations(i);
+        double s = 0.0;
+        for (int k = 0; k < storage->header().num_constraints; ++k) s += v[k];
+        return s;
+    }
+
+    // is_better_solution() of individual a over individual b, and over 'other'
+    bool better_at(int a, int b) const {
+        if (!storage) return is_better_solution(population[a], population[b]);
+        return better_values(objective_at(a), violation_sum_at(a), objective_at(b), violation_sum_at(b));
+    }
+    bool better_than(int a, const Individual& other) const {
+        if (!storage) return is_better_solution(population[a], other);
+        return better_values(objective_at(a), violation_sum_at(a), other.objective_value, violation_sum(other));
+    }
+
+    // Row 'row' of a population file into 'ind', and back
+    void read_row(const MappedPopulation& file, int row, Individual& ind) const {
+        const double* x = file.variables(row);
+        const double* v = file.violations(row);
+        ind.variables.assign(x, x + n_variables);
+        ind.constraint_violations.assign(v, v + file.header().num_constraints);
+        ind.objective_value = file.objective(row);
+        ind.rank = file.rank(row);
+    }
+    static void write_row(MappedPopulation& file, int row, const Individual& ind) {
+        const size_t c = std::min(ind.constraint_violations.size(), static_cast<size_t>(file.header().num_constraints));
+        std::copy(ind.variables.begin(), ind.variables.end(), file.variables(row));
+        std::copy_n(ind.constraint_violations.begin(), c, file.violations(row));
+        file.objective(row) = ind.objective_value;
+        file.rank(row) = ind.rank;
+    }
+
+    // Societies, best-ever row, counters and RNG state of a checkpoint
+    void write_checkpoint_state(MappedPopulation& file) {
+        const bool assigned = (int)assignments.size() == m_pop_size;
+        for (int i = 0; i < m_pop_size; ++i) file.society(i) = assigned ? assignments[i] : -1;
+        if (m_has_best_ever) write_row(file, file.header().capacity, best_ever);
+
+        MappedPopulation::Header& h = file.header();
+        h.size = m_pop_size;
+        h.time_step = m_time_step;
+        h.evaluations = m_evaluations;
+        h.epsilon = m_epsilon;
+        h.epsilon0 = m_epsilon0;
+        h.has_best_ever = m_has_best_ever ? 1 : 0;
+        std::ostringstream rng_text;
+        rng_text << rng;
+        file.set_rng_state(rng_text.str());
+    }
+    void read_checkpoint_state(const MappedPopulation& file) {
+        const MappedPopulation::Header& h = file.header();
+        m_pop_size = h.size;
+        assignments.resize(m_pop_size);
+        for (int i = 0; i < m_pop_size; ++i) {
+            const int society = file.society(i);
+            if (society < -1 || society >= m_pop_size) throw std::runtime_error("restore_checkpoint(): corrupt society column");
+            assignments[i] = society;
+        }
+
+        has_evaluated_position.clear();
+        moved.clear();
+        bandit_gain.clear();
+        m_has_best_ever = h.has_best_ever != 0;
+        best_ever = Individual(n_variables);
+        if (m_has_best_ever) read_row(file, h.capacity, best_ever);
+        expected_constraint_dim = h.evaluations > 0 ? static_cast<size_t>(h.num_constraints) : static_cast<size_t>(-1);
+        m_time_step = h.time_step;
+        m_evaluations = h.evaluations;
+        m_epsilon = h.epsilon;
+        m_epsilon0 = h.epsilon0;
+        std::istringstream rng_text(file.rng_state());
+        rng_text >> rng;
+        if (!rng_text) throw std::runtime_error("restore_checkpoint(): corrupt RNG state");
     }
 
     // --- Helper: Distance ---
@@ -91,12 +804,33 @@ public:
         return std::sqrt(sum);
     }
 
+    // calculate_distance() of individuals a and b
+    double distance_at(int a, int b) const {
+        const double* x = position(a);
+        const double* y = position(b);
+        double sum = 0.0;
+        for (int i = 0; i < n_variables; ++i) {
+            double diff = x[i] - y[i];
+            sum += diff * diff;
+        }
+        return std::sqrt(sum);
+    }
+
     // --- Step 2: Clustering (Existing logic) ---
+    // Each point's distance to its own hub and all hub-to-hub distances are
+    // kept, so every distance is computed once. When a hub is added, a point
+    // whose hub is at least twice its own distance away from the new hub
+    // cannot be closer to the new hub (triangle inequality) and is skipped.
+    // The assignments, and the sums behind the stopping distance D, are
+    // those of computing every distance.
     void cluster_population() {
-        if (population.empty()) return;
+        if (population_count() == 0) return;
 
         hubs.clear();
         assignments.assign(m_pop_size, -1);
+        own_hub_distance.resize(m_pop_size);
+        hub_pairs.clear();
+        long long computed = 0, reused = 0, pruned = 0;
 
         // 1. Initial Hubs
         std::uniform_int_distribution<int> dist_idx(0, m_pop_size - 1);
@@ -105,17 +839,24 @@ public:
         int second_hub = -1;
         double max_dist = -1.0;
         for (int i = 0; i < m_pop_size; ++i) {
-            double d = calculate_distance(population[i], population[hubs[0]]);
+            double d = distance_at(i, hubs[0]);
+            own_hub_distance[i] = d;
             if (d > max_dist) { max_dist = d; second_hub = i; }
         }
         hubs.push_back(second_hub);
+        hub_pairs.push_back(own_hub_distance[second_hub]);
+        computed += m_pop_size;
+        reused++;
 
         // Initial assignment
         for (int i = 0; i < m_pop_size; ++i) {
-            double d1 = calculate_distance(population[i], population[hubs[0]]);
-            double d2 = calculate_distance(population[i], population[hubs[1]]);
+            double d1 = own_hub_distance[i];
+            double d2 = distance_at(i, hubs[1]);
             assignments[i] = (d1 <= d2) ? 0 : 1;
+            own_hub_distance[i] = (d1 <= d2) ? d1 : d2;
         }
+        computed += m_pop_size;
+        reused += m_pop_size;
 
         // Clustering Loop
         while (true) {
@@ -123,51 +864,414 @@ public:
             int pairs = 0;
             for (size_t i = 0; i < hubs.size(); ++i) {
                 for (size_t j = i + 1; j < hubs.size(); ++j) {
-                    total_dist += calculate_distance(population[hubs[i]], population[hubs[j]]);
+                    total_dist += hub_pairs[j * (j - 1) / 2 + i];
                     pairs++;
                 }
             }
+            reused += pairs;
             double D = (pairs > 0) ? (total_dist / pairs) / 2.0 : 0.0;
 
             int farthest_idx = -1;
             double max_d = -1.0;
             for (int i = 0; i < m_pop_size; ++i) {
-                int hub_idx = hubs[assignments[i]];
-                double d = calculate_distance(population[i], population[hub_idx]);
+                double d = own_hub_distance[i];
                 if (d > max_d) { max_d = d; farthest_idx = i; }
             }
+            reused += m_pop_size;
 
             if (max_d <= D) break;
+            if (m_max_hubs > 0 && (int)hubs.size() >= m_max_hubs) break;
 
             hubs.push_back(farthest_idx);
             int new_hub_id = hubs.size() - 1;
+            for (int h = 0; h < new_hub_id; ++h) hub_pairs.push_back(distance_at(hubs[h], farthest_idx));
+            computed += new_hub_id;
 
+            // The margin covers rounding: a skipped point's computed distance
+            // to the new hub could not have come out below its own
+            const double* to_new = hub_pairs.data() + static_cast<size_t>(new_hub_id) * (new_hub_id - 1) / 2;
             for (int i = 0; i < m_pop_size; ++i) {
-                int curr = hubs[assignments[i]];
-                double d_curr = calculate_distance(population[i], population[curr]);
-                double d_new = calculate_distance(population[i], population[farthest_idx]);
-                if (d_new < d_curr) assignments[i] = new_hub_id;
+                const double d_curr = own_hub_distance[i];
+                if (to_new[assignments[i]] >= 2.0 * d_curr * (1.0 + 1e-9)) {
+                    pruned++;
+                    continue;
+                }
+                double d_new = distance_at(i, farthest_idx);
+                computed++;
+                if (d_new < d_curr) {
+                    assignments[i] = new_hub_id;
+                    own_hub_distance[i] = d_new;
+                }
             }
+            reused += m_pop_size;
         }
+        clustering_stats.distance_evals += computed;
+        clustering_stats.reused += reused;
+        clustering_stats.pruned += pruned;
+        if (m_min_society > 1) merge_small_societies();
         //std::cout << "--> Clustering complete. Societies formed: " << hubs.size() << "\n";
-        organize_societies();
+        // organize_societies() only rebuilt lists that identify_leaders() builds anyway
+    }
+
+    // Dissolves societies below m_min_society members, smallest first (lowest
+    // id on ties), while more than one society is left; their members join
+    // the nearest remaining hub. Society ids are then renumbered in hub order.
+    void merge_small_societies() {
+        const int num_hubs = static_cast<int>(hubs.size());
+        society_size.assign(num_hubs, 0);
+        for (int i = 0; i < m_pop_size; ++i) society_size[assignments[i]]++;
+        int remaining = num_hubs;
+
+        while (remaining > 1) {
+            int smallest = -1;
+            for (int h = 0; h < num_hubs; ++h) {
+                if (society_size[h] < 0) continue; // dissolved
+                if (smallest == -1 || society_size[h] < society_size[smallest]) smallest = h;
+            }
+            if (society_size[smallest] >= m_min_society) break;
+            society_size[smallest] = -1;
+            remaining--;
+
+            for (int i = 0; i < m_pop_size; ++i) {
+                if (assignments[i] != smallest) continue;
+                int nearest = -1;
+                double min_dist = std::numeric_limits<double>::max();
+                for (int h = 0; h < num_hubs; ++h) {
+                    if (society_size[h] < 0) continue;
+                    const double d = distance_at(i, hubs[h]);
+                    if (d < min_dist) { min_dist = d; nearest = h; }
+                }
+                assignments[i] = nearest;
+                society_size[nearest]++;
+            }
+        }
+        if (remaining == num_hubs) return;
+
+        hub_renumber.assign(num_hubs, -1);
+        int kept = 0;
+        for (int h = 0; h < num_hubs; ++h) {
+            if (society_size[h] < 0) continue;
+            hub_renumber[h] = kept;
+            hubs[kept++] = hubs[h];
+        }
+        hubs.resize(kept);
+        for (int i = 0; i < m_pop_size; ++i) assignments[i] = hub_renumber[assignments[i]];
     }
 
     // Step 3 - Leader Identification ---
 
     // 3.1 Evaluate using Generic Functors
     void evaluate_population() {
-        for (auto& ind : population) {
+        // With repair or the bandit, only the individuals in eval_list are evaluated
+        const int count = population_count();
+        const bool selective = m_repair != REPAIR_NONE || m_bandit;
+        int todo = count;
+        if (selective) {
+            eval_list.clear();
+            if (m_bandit && (int)moved.size() != count) moved.assign(count, 1);
+            for (int i = 0; i < count; ++i) {
+                if (!m_bandit || moved[i]) eval_list.push_back(i);
+            }
+            todo = m_repair != REPAIR_NONE ? repair_population() : static_cast<int>(eval_list.size());
+        }
+        auto index = [this, selective](int k) { return selective ? eval_list[k] : k; };
+
+        // Bandit: values before the move, to score it (none before the first evaluation)
+        const bool score_moves = m_bandit && expected_constraint_dim != static_cast<size_t>(-1);
+        if (score_moves) {
+            bandit_prev.resize(todo);
+            for (int k = 0; k < todo; ++k) bandit_prev[k] = { objective_at(index(k)), violation_sum_at(index(k)) };
+        }
+
+        if (m_cost_aware && !m_batch_fn) {
+            cost_model.refit();
+            m_eval_predicted.resize(count);
+            m_eval_seconds.assign(count, 0.0);
+            m_eval_order.clear();
+        }
+
+        // In memory the whole list is one window. Out of core each window of
+        // list entries is hydrated into eval_window, evaluated and written back.
+        const int window = storage ? storage_window() : std::max(todo, 1);
+        for (int first = 0; first < todo; first += window) {
+            const int last = std::min(todo, first + window);
+            auto at = [&](int k) -> Individual& { return storage ? eval_window[k - first] : population[index(k)]; };
+            if (storage) {
+                storage->advise(index(first), index(last - 1) - index(first) + 1, true);
+                if ((int)eval_window.size() < last - first) eval_window.resize(last - first, Individual(n_variables));
+                for (int k = first; k < last; ++k) read_row(*storage, index(k), at(k));
+            }
+            evaluate_window(first, last, index, at);
+            if (recorder) {
+                for (int k = first; k < last; ++k) recorder->record(at(k));
+            }
+            if (storage) {
+                for (int k = first; k < last; ++k) store_evaluation(index(k), at(k));
+                storage->advise(index(first), index(last - 1) - index(first) + 1, false);
+            }
+        }
+        m_evaluations += todo;
+
+        if (m_repair == REPAIR_REJECT) {
+            for (int k = 0; k < todo; ++k) {
+                const int i = index(k);
+                std::copy(population[i].variables.begin(), population[i].variables.end(),
+                    evaluated_positions.begin() + static_cast<size_t>(i) * n_variables);
+                has_evaluated_position[i] = 1;
+            }
+        }
+
+        if (score_moves) {
+            if ((int)bandit_gain.size() != count) bandit_gain.assign(count, 1.0);
+            for (int k = 0; k < todo; ++k) {
+                const int i = index(k);
+                const double v = violation_sum_at(i);
+                const bool improved = v < bandit_prev[k].second ||
+                    (v == bandit_prev[k].second && objective_at(i) < bandit_prev[k].first);
+                bandit_gain[i] = m_bandit_decay * bandit_gain[i] + (1.0 - m_bandit_decay) * (improved ? 1.0 : 0.0);
+            }
+        }
+        if (m_bandit) std::fill(moved.begin(), moved.end(), 0);
+
+        int best_idx = -1;
+        for (int i = 0; i < count; ++i) {
+            if (!storage) {
+                const Individual& ind = population[i];
+                if (expected_constraint_dim == static_cast<size_t>(-1)) {
+                    expected_constraint_dim = ind.constraint_violations.size();
+                }
+                else if (ind.constraint_violations.size() != expected_constraint_dim) {
+                    throw std::runtime_error("Constraint vector size changed between evaluations");
+                }
+            }
+            if (best_idx == -1 || better_at(i, best_idx)) best_idx = i;
+        }
+        if (best_idx != -1 && (!m_has_best_ever || better_than(best_idx, best_ever))) {
+            // Assigned in place, so a new best reuses best_ever's vectors
+            if (storage) read_row(*storage, best_idx, best_ever);
+            else best_ever = population[best_idx];
+            m_has_best_ever = true;
+        }
+    }
+
+    // Evaluates list entries [first, last) through the batch function, the
+    // cost-aware list schedule, the runtime or serially; at(k) is the
+    // Individual of entry k and index(k) its population index
+    template <class Index, class At>
+    void evaluate_window(int first, int last, const Index& index, const At& at) {
+        auto evaluate = [this](Individual& ind) {
+            LicensePool::Lease token(license_pool.get(), m_license_client);
             ind.objective_value = m_objective_fn(ind);
-            ind.constraint_violations = m_constraint_fn(ind);
+            if (m_constraint_writer) m_constraint_writer(ind, ind.constraint_violations);
+            else ind.constraint_violations = m_constraint_fn(ind);
+        };
+        const int todo = last - first;
+
+        if (m_batch_fn) {
+            eval_batch.resize(todo);
+            for (int k = first; k < last; ++k) eval_batch[k - first] = &at(k);
+            if (todo > 0) {
+                LicensePool::Lease token(license_pool.get(), m_license_client);
+                m_batch_fn(eval_batch);
+            }
+        }
+        else if (m_cost_aware) {
+            // Longest predicted first: with list scheduling this is the LPT rule.
+            // m_eval_order holds list entries until they are mapped to indices.
+            const size_t base = m_eval_order.size();
+            for (int k = first; k < last; ++k) {
+                m_eval_order.push_back(k);
+                m_eval_predicted[index(k)] = cost_model.predict(at(k).variables);
+            }
+            std::stable_sort(m_eval_order.begin() + base, m_eval_order.end(),
+                [&](int a, int b) { return m_eval_predicted[index(a)] > m_eval_predicted[index(b)]; });
+
+            auto timed = [&](int t) {
+                const int k = m_eval_order[base + t];
+                const auto start = std::chrono::steady_clock::now();
+                evaluate(at(k));
+                m_eval_seconds[index(k)] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            };
+            if (m_parallel_evaluation) TaskRuntime::instance().parallel_for_dynamic(0, todo, timed);
+            else for (int t = 0; t < todo; ++t) timed(t);
+
+            for (int k = first; k < last; ++k) cost_model.record(at(k).variables, m_eval_seconds[index(k)]);
+            for (size_t t = base; t < m_eval_order.size(); ++t) m_eval_order[t] = index(m_eval_order[t]);
+        }
+        else if (m_parallel_evaluation) TaskRuntime::instance().parallel_for(first, last, [&](int k) { evaluate(at(k)); });
+        else for (int k = first; k < last; ++k) evaluate(at(k));
+    }
 
-            if (expected_constraint_dim == static_cast<size_t>(-1)) {
-                expected_constraint_dim = ind.constraint_violations.size();
+    // Writes the evaluated 'ind' back to row i of the population storage; the
+    // first evaluation sizes the violations column
+    void store_evaluation(int i, const Individual& ind) {
+        const size_t c = ind.constraint_violations.size();
+        if (expected_constraint_dim == static_cast<size_t>(-1)) {
+            storage->set_constraints(static_cast<int>(c));
+            expected_constraint_dim = c;
+        }
+        else if (c != expected_constraint_dim) {
+            throw std::runtime_error("Constraint vector size changed between evaluations");
+        }
+        std::copy(ind.variables.begin(), ind.variables.end(), storage->variables(i));
+        std::copy(ind.constraint_violations.begin(), ind.constraint_violations.end(), storage->violations(i));
+        storage->objective(i) = ind.objective_value;
+    }
+
+    // Cheap-constraint check before evaluation: keeps in eval_list the
+    // candidates to evaluate and returns their number
+    int repair_population() {
+        if (storage && m_repair == REPAIR_REJECT) {
+            throw std::logic_error("REPAIR_REJECT is not available with population storage");
+        }
+        const int count = population_count();
+        if ((int)has_evaluated_position.size() != count) {
+            has_evaluated_position.assign(count, 0);
+            evaluated_positions.resize(static_cast<size_t>(count) * n_variables);
+        }
+        size_t kept = 0;
+        for (size_t k = 0; k < eval_list.size(); ++k) {
+            const int i = eval_list[k];
+            double* x = position(i);
+            repair_stats.checked++;
+            if (linear_constraints.satisfied(x)) {
+                eval_list[kept++] = i;
+                continue;
             }
-            else if (ind.constraint_violations.size() != expected_constraint_dim) {
-                throw std::runtime_error("Constraint vector size changed between evaluations");
+            if (m_repair == REPAIR_REJECT && has_evaluated_position[i]) {
+                std::copy(evaluated_positions.begin() + static_cast<size_t>(i) * n_variables,
+                    evaluated_positions.begin() + static_cast<size_t>(i + 1) * n_variables, x);
+                repair_stats.rejected++;
+                continue;
             }
+            if (linear_constraints.project(x, lower_bounds, upper_bounds)) repair_stats.projected++;
+            else repair_stats.unrepaired++;
+            eval_list[kept++] = i;
         }
+        eval_list.resize(kept);
+        return static_cast<int>(kept);
+    }
+
+    // Solution order used for reporting: feasible before infeasible, then lower
+    // objective among feasible, lower violation sum among infeasible
+    static bool is_better_solution(const Individual& a, const Individual& b) {
+        return better_values(a.objective_value, violation_sum(a), b.objective_value, violation_sum(b));
+    }
+
+    // is_better_solution() on objective values and violation sums
+    static bool better_values(double oa, double va, double ob, double vb) {
+        const bool fa = va <= FEAS_EPS;
+        const bool fb = vb <= FEAS_EPS;
+        if (fa != fb) return fa;
+        if (fa) return oa < ob;
+        return va < vb || (va == vb && oa < ob);
+    }
+
+    bool has_best_ever() const { return m_has_best_ever; }
+    const Individual& get_best_ever() const { return best_ever; }
+
+    // Replaces the currently worst individual with an already evaluated one
+    // (e.g. an elite from another civilization on the same problem)
+    void inject_individual(const Individual& ind) {
+        if ((int)ind.variables.size() != n_variables) {
+            throw std::invalid_argument("inject_individual(): variable count mismatch");
+        }
+        if (population_count() == 0) return;
+        int worst = 0;
+        for (int i = 1; i < m_pop_size; ++i) {
+            if (better_at(worst, i)) worst = i;
+        }
+        if (storage) {
+            if (ind.constraint_violations.size() != static_cast<size_t>(storage->header().num_constraints)) {
+                throw std::invalid_argument("inject_individual(): constraint count mismatch");
+            }
+            write_row(*storage, worst, ind);
+        }
+        else population[worst] = ind;
+        if (worst < (int)moved.size()) moved[worst] = 0;
+        if (worst < (int)has_evaluated_position.size() && has_evaluated_position[worst]) {
+            std::copy(ind.variables.begin(), ind.variables.end(), evaluated_positions.begin() + static_cast<size_t>(worst) * n_variables);
+        }
+        if (!m_has_best_ever || is_better_solution(ind, best_ever)) {
+            best_ever = ind;
+            m_has_best_ever = true;
+        }
+    }
+
+    // One time step of the algorithm (Steps 2-8)
+    void step() {
+        const auto start = std::chrono::steady_clock::now();
+        cluster_population();
+        identify_leaders();
+        move_society_members();
+        form_global_society();
+        identify_super_leaders();
+        move_global_leaders();
+        if (!m_checkpoint_path.empty() && m_time_step % m_checkpoint_every == 0) save_checkpoint(m_checkpoint_path);
+
+        m_step_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        m_step_seconds_avg = m_step_seconds_avg > 0.0 ? 0.8 * m_step_seconds_avg + 0.2 * m_step_seconds : m_step_seconds;
+    }
+
+    // Takes one step, then more while the next one is predicted to finish
+    // within 'budget' (the slower of the last step and the recent average),
+    // e.g. from a UI timer. Only a single step slower than the budget can
+    // overrun it. Returns the number of steps taken.
+    template <class Rep, class Period>
+    int step_for(std::chrono::duration<Rep, Period> budget) {
+        const auto start = std::chrono::steady_clock::now();
+        const double budget_seconds = std::chrono::duration<double>(budget).count();
+        int steps = 0;
+        do {
+            step();
+            steps++;
+        } while (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() +
+            std::max(m_step_seconds, m_step_seconds_avg) <= budget_seconds);
+        return steps;
+    }
+
+    // Completed steps since initialize()/reseed()
+    int time_step() const { return m_time_step; }
+    double last_step_seconds() const { return m_step_seconds; }
+
+    // Sizes every per-step buffer for the worst case (one society holding the
+    // whole population, every agent a leader): about 2*m*m ints, meant for
+    // interactive population sizes. After this and one step, step() does not
+    // allocate, provided constraints come through set_constraint_writer() and
+    // none of approximate search, cost-aware scheduling, population storage,
+    // checkpoints or license pool is enabled.
+    void reserve_step_buffers() {
+        const size_t m = static_cast<size_t>(m_pop_size);
+        hubs.reserve(m);
+        assignments.reserve(m);
+        global_society.reserve(m);
+        super_leaders.reserve(m);
+        movers.reserve(m);
+        cap_crowding.reserve(m);
+        cap_order.reserve(m);
+        own_hub_distance.reserve(m);
+        hub_pairs.reserve(m * (m - 1) / 2);
+        society_size.reserve(m);
+        hub_renumber.reserve(m);
+        move_chosen.reserve(m);
+        bandit_quota.reserve(m);
+        bandit_score.reserve(m);
+        bandit_order.reserve(m);
+        bandit_pool.reserve(m);
+        bandit_prev.reserve(m);
+        eval_batch.reserve(m);
+        eval_list.reserve(m);
+        prev_objective.reserve(m);
+        prev_violation.reserve(m);
+        influence.reserve(m);
+        society_probs.reserve(m);
+        societies.reserve(m);
+        society_leaders.reserve(m);
+        spare_lists.reserve(2 * m);
+        while (spare_lists.size() + societies.size() + society_leaders.size() < 2 * m) spare_lists.emplace_back();
+        for (auto& list : spare_lists) list.reserve(m);
+        for (auto& list : societies) list.reserve(m);
+        for (auto& list : society_leaders) list.reserve(m);
     }
 
 
@@ -181,6 +1285,13 @@ public:
             throw std::runtime_error("dominates(): mismatched constraint vector sizes");
         }
 
+        // Epsilon-feasible individuals behave as if all violations were zero
+        if (m_epsilon > 0.0) {
+            const bool a_feasible = violation_sum(a) <= m_epsilon;
+            const bool b_feasible = violation_sum(b) <= m_epsilon;
+            if (a_feasible || b_feasible) return a_feasible && !b_feasible;
+        }
+
         bool no_worse = true;
         bool strictly_better = false;
 
@@ -196,70 +1307,285 @@ public:
         return no_worse && strictly_better;
     }
 
+    // dominates() of individual a over individual b
+    bool dominates_at(int a, int b) {
+        if (!storage) return dominates(population[a], population[b]);
+        if (m_epsilon > 0.0) {
+            const bool a_feasible = violation_sum_at(a) <= m_epsilon;
+            const bool b_feasible = violation_sum_at(b) <= m_epsilon;
+            if (a_feasible || b_feasible) return a_feasible && !b_feasible;
+        }
+        const double* va = storage->violations(a);
+        const double* vb = storage->violations(b);
+        bool strictly_better = false;
+        for (int k = 0; k < storage->header().num_constraints; ++k) {
+            if (va[k] > vb[k]) return false;
+            if (va[k] < vb[k]) strictly_better = true;
+        }
+        return strictly_better;
+    }
+
 
     // 3.2 Rank Society
+    // Peels off one front per round. The pool of round r is the members with
+    // rank 0 (unranked) or -r (ranked in this round, kept in the pool until
+    // the round ends), so no pool lists are needed.
     void rank_society(const std::vector<int>& members) {
-        std::vector<int> current_pool = members;
+        for (int i : members) set_rank(i, 0);
+        size_t unranked = members.size();
         int current_rank = 1;
-        while (!current_pool.empty()) {
-            std::vector<int> next_pool;
-            for (int i : current_pool) {
+        while (unranked > 0) {
+            for (int i : members) {
+                if (rank_at(i) != 0) continue;
                 bool is_dominated = false;
-                for (int j : current_pool) {
+                for (int j : members) {
                     if (i == j) continue;
-                    if (dominates(population[j], population[i])) {
+                    const int rj = rank_at(j);
+                    if (rj != 0 && rj != -current_rank) continue;
+                    if (dominates_at(j, i)) {
                         is_dominated = true; break;
                     }
                 }
-                if (!is_dominated) population[i].rank = current_rank;
-                else next_pool.push_back(i);
+                if (!is_dominated) set_rank(i, -current_rank);
+            }
+            for (int i : members) {
+                if (rank_at(i) == -current_rank) {
+                    set_rank(i, current_rank);
+                    unranked--;
+                }
             }
-            current_pool = next_pool;
             current_rank++;
         }
     }
 
+    // Leaders of a ranked society: its rank-1 members, or, when those are
+    // more than half of it, the rank-1 members at or below the mean objective
+    // (the first rank-1 member if none is)
+    void select_leaders(const std::vector<int>& members, std::vector<int>& leaders) {
+        leaders.clear();
+        size_t rank1 = 0;
+        int first_rank1 = -1;
+        double sum_obj = 0.0;
+        for (int idx : members) {
+            sum_obj += objective_at(idx);
+            if (rank_at(idx) == 1) {
+                if (rank1++ == 0) first_rank1 = idx;
+            }
+        }
+
+        const double avg_obj = (members.size() > 0) ? sum_obj / members.size() : 0.0;
+        const bool filter = rank1 > (members.size() * 0.5);
+        for (int idx : members) {
+            if (rank_at(idx) == 1 && (!filter || objective_at(idx) <= avg_obj))
+                leaders.push_back(idx);
+        }
+        if (leaders.empty() && first_rank1 != -1) leaders.push_back(first_rank1);
+    }
+
+    // Resizes a list of lists, parking removed lists in spare_lists and
+    // reusing them when it grows, so their capacity survives; every list is
+    // left empty
+    void resize_lists(std::vector<std::vector<int>>& lists, size_t count) {
+        while (lists.size() > count) {
+            spare_lists.push_back(std::move(lists.back()));
+            lists.pop_back();
+        }
+        for (auto& list : lists) list.clear();
+        while (lists.size() < count) {
+            if (spare_lists.empty()) lists.emplace_back();
+            else {
+                lists.push_back(std::move(spare_lists.back()));
+                spare_lists.pop_back();
+                lists.back().clear();
+            }
+        }
+    }
+
     // 3.3 Identify Leaders
     void identify_leaders() {
+        // Values from the previous evaluation, i.e. from before the last move
+        prev_objective.clear();
+        prev_violation.clear();
+        if (m_adaptive_operators && !region_uses.empty()) {
+            prev_objective.resize(m_pop_size);
+            prev_violation.resize(m_pop_size);
+            for (int i = 0; i < m_pop_size; ++i) {
+                prev_objective[i] = objective_at(i);
+                prev_violation[i] = violation_sum_at(i);
+            }
+        }
+
         evaluate_population();
+        if (m_epsilon_schedule) update_epsilon();
+        m_time_step++;
 
         int num_societies = hubs.size();
-        std::vector<std::vector<int>> societies(num_societies);
+        resize_lists(societies, num_societies);
         for (int i = 0; i < m_pop_size; ++i)
             if (assignments[i] >= 0) societies[assignments[i]].push_back(i);
 
-        society_leaders.clear();
-        society_leaders.resize(num_societies);
+        if (m_adaptive_operators) adapt_operator_probabilities(societies, prev_objective, prev_violation);
 
-        for (int s = 0; s < num_societies; ++s) {
-            std::vector<int>& members = societies[s];
-            if (members.empty()) continue;
+        resize_lists(society_leaders, num_societies);
+
+        // Societies are disjoint, so each one can be ranked independently
+        auto lead_society = [&](int s) {
+            const std::vector<int>& members = societies[s];
+            if (members.empty()) return;
 
             rank_society(members);
+            select_leaders(members, society_leaders[s]);
+            if (m_max_leaders > 0) cap_leaders(society_leaders[s], m_max_leaders);
+        };
+
+        if (m_parallel_societies) TaskRuntime::instance().parallel_for(0, num_societies, lead_society);
+        else for (int s = 0; s < num_societies; ++s) lead_society(s);
+        //std::cout << "--> Leaders Identified via Generic Functors.\n";
+    }
+
+    // Keeps the k best of 'leaders' (in their original order). Ties are broken
+    // by crowding: the distance, in bound-normalised variables, to the nearest
+    // other candidate; more isolated candidates are kept first.
+    void cap_leaders(std::vector<int>& leaders, int k) {
+        if ((int)leaders.size() <= k) return;
+
+        const size_t count = leaders.size();
+        std::vector<double>& crowding = cap_crowding; // computed only if a tie needs it
+        bool crowding_ready = false;
+        auto crowding_of = [&](size_t p) {
+            if (!crowding_ready) {
+                crowding_ready = true;
+                crowding.assign(count, std::numeric_limits<double>::max());
+                for (size_t a = 0; a < count; ++a) {
+                    for (size_t b = a + 1; b < count; ++b) {
+                        double d = 0.0;
+                        for (int j = 0; j < n_variables; ++j) {
+                            const double span = upper_bounds[j] - lower_bounds[j];
+                            const double diff = (position(leaders[a])[j] - position(leaders[b])[j]) /
+                                (span > 0.0 ? span : 1.0);
+                            d += diff * diff;
+                        }
+                        crowding[a] = std::min(crowding[a], d);
+                        crowding[b] = std::min(crowding[b], d);
+                    }
+                }
+            }
+            return crowding[p];
+        };
+
+        // Positions into 'leaders', best first; the position breaks the
+        // remaining ties, as a stable sort would (std::sort needs no buffer)
+        std::vector<size_t>& order = cap_order;
+        order.resize(count);
+        for (size_t p = 0; p < count; ++p) order[p] = p;
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            if (better_at(leaders[a], leaders[b])) return true;
+            if (better_at(leaders[b], leaders[a])) return false;
+            const double ca = crowding_of(a), cb = crowding_of(b);
+            if (ca != cb) return ca > cb;
+            return a < b;
+        });
+        order.resize(k);
+        std::sort(order.begin(), order.end());
+
+        // Compacted in place: order[i] >= i, so no kept entry is overwritten
+        // before it is read
+        for (int i = 0; i < k; ++i) leaders[i] = leaders[order[i]];
+        leaders.resize(k);
+    }
+
+    // Advances the epsilon schedule for the step about to be ranked
+    void update_epsilon() {
+        if (m_epsilon0 < 0.0) {
+            std::vector<double> sums(population_count());
+            for (size_t i = 0; i < sums.size(); ++i) sums[i] = violation_sum_at(static_cast<int>(i));
+            size_t k = static_cast<size_t>(m_epsilon_quantile * (sums.size() - 1));
+            std::nth_element(sums.begin(), sums.begin() + k, sums.end());
+            m_epsilon0 = sums[k];
+        }
+
+        if (m_time_step >= m_epsilon_steps) {
+            m_epsilon = 0.0;
+            return;
+        }
+        const double remaining = 1.0 - static_cast<double>(m_time_step) / m_epsilon_steps;
+        m_epsilon = m_epsilon0 * std::pow(remaining, m_epsilon_exponent);
+    }
+
+    // Sum of constraint violations (0 when feasible)
+    static double violation_sum(const Individual& ind) {
+        double s = 0.0;
+        for (double v : ind.constraint_violations) s += v;
+        return s;
+    }
+
+    // Violation sum up to which a solution counts as feasible wherever it is
+    // reported or kept; the epsilon schedule only relaxes ranking
+    static constexpr double FEAS_EPS = 1e-12;
+    static bool is_feasible(const Individual& ind) { return violation_sum(ind) <= FEAS_EPS; }
+
+    // Credit assignment for the adaptive operator. A move counts as an
+    // improvement if it lowered the violation sum, or kept it and lowered the
+    // objective; each region is credited with its share of the moved variables.
+    // The pooled quality is smoothed with the new success rates and turned into
+    // bounded probabilities by probability matching.
+    void adapt_operator_probabilities(const std::vector<std::vector<int>>& societies,
+        const std::vector<double>& prev_objective,
+        const std::vector<double>& prev_violation) {
+        const double p_min = m_adaptive_min_prob;
+
+        if ((int)region_quality.size() != m_pop_size) {
+            // Start from the fixed split: q_k proportional to (p_k - p_min)
+            RegionProbs q0;
+            for (int k = 0; k < NUM_REGIONS; ++k)
+                q0[k] = (FIXED_REGION_PROBS[k] - p_min) / (1.0 - NUM_REGIONS * p_min);
+            region_quality.assign(m_pop_size, q0);
+            region_uses.assign(m_pop_size, { 0, 0, 0 });
+        }
+
+        society_probs.assign(societies.size(), FIXED_REGION_PROBS);
+        for (size_t s = 0; s < societies.size(); ++s) {
+            const std::vector<int>& members = societies[s];
+            if (members.empty()) continue;
+
+            RegionProbs q = { 0.0, 0.0, 0.0 };
+            RegionProbs uses = { 0.0, 0.0, 0.0 };
+            RegionProbs successes = { 0.0, 0.0, 0.0 };
 
-            std::vector<int> rank1;
-            double sum_obj = 0.0;
             for (int idx : members) {
-                sum_obj += population[idx].objective_value;
-                if (population[idx].rank == 1) rank1.push_back(idx);
+                for (int k = 0; k < NUM_REGIONS; ++k) q[k] += region_quality[idx][k];
+
+                const int moved = region_uses[idx][0] + region_uses[idx][1] + region_uses[idx][2];
+                if (moved == 0 || prev_objective.empty()) continue;
+
+                const double v = violation_sum_at(idx);
+                const bool improved = (v < prev_violation[idx]) ||
+                    (v == prev_violation[idx] && objective_at(idx) < prev_objective[idx]);
+
+                for (int k = 0; k < NUM_REGIONS; ++k) {
+                    const double share = static_cast<double>(region_uses[idx][k]) / moved;
+                    uses[k] += share;
+                    if (improved) successes[k] += share;
+                }
             }
 
-            double avg_obj = (members.size() > 0) ? sum_obj / members.size() : 0.0;
-            bool filter = rank1.size() > (members.size() * 0.5);
+            double total = 0.0;
+            for (int k = 0; k < NUM_REGIONS; ++k) {
+                q[k] /= members.size();
+                if (uses[k] > 0.0) q[k] = (1.0 - m_adaptive_rate) * q[k] + m_adaptive_rate * (successes[k] / uses[k]);
+                total += q[k];
+            }
 
-            if (!filter) {
-                society_leaders[s] = rank1;
+            if (total > 0.0) {
+                for (int k = 0; k < NUM_REGIONS; ++k)
+                    society_probs[s][k] = p_min + (1.0 - NUM_REGIONS * p_min) * q[k] / total;
             }
-            else {
-                for (int idx : rank1) {
-                    if (population[idx].objective_value <= avg_obj)
-                        society_leaders[s].push_back(idx);
-                }
-                if (society_leaders[s].empty() && !rank1.empty())
-                    society_leaders[s].push_back(rank1[0]);
+
+            for (int idx : members) {
+                region_quality[idx] = q;
+                region_uses[idx] = { 0, 0, 0 };
             }
         }
-        //std::cout << "--> Leaders Identified via Generic Functors.\n";
     }
 
     // Step 4 Helpers & Logic ---
@@ -279,6 +1605,13 @@ public:
     // Section 3.5: Information Acquisition Operator
     // Implements the stochastic movement logic
     double acquire_information(double val_ind, double val_leader, double lb, double ub) {
+        int region;
+        return acquire_information(val_ind, val_leader, lb, ub, FIXED_REGION_PROBS, region);
+    }
+
+    // Same operator with explicit region probabilities; reports the region chosen
+    double acquire_information(double val_ind, double val_leader, double lb, double ub,
+        const RegionProbs& probs, int& region) {
         std::uniform_real_distribution<double> dist(0.0, 1.0);
         double r = dist(rng);
 
@@ -286,58 +1619,275 @@ public:
         double max_v = std::max(val_ind, val_leader);
 
         // Define the 3 regions from Figure 2
-        if (r < 0.25) {
+        if (r < probs[BELOW_MIN]) {
             // 25% prob: Move between Lower Bound and min(ind, leader)
+            region = BELOW_MIN;
             if (min_v <= lb) return lb;
             std::uniform_real_distribution<double> range(lb, min_v);
             return range(rng);
         }
-        else if (r < 0.75) {
+        else if (r < probs[BELOW_MIN] + probs[BETWEEN]) {
             // 50% prob: Move between Individual and Leader
+            region = BETWEEN;
             if (max_v <= min_v) return min_v;
             std::uniform_real_distribution<double> range(min_v, max_v);
             return range(rng);
         }
         else {
             // 25% prob: Move between max(ind, leader) and Upper Bound
+            region = ABOVE_MAX;
             if (ub <= max_v) return ub;
             std::uniform_real_distribution<double> range(max_v, ub);
             return range(rng);
         }
     }
 
+    // Moves every variable of 'mover' towards 'guide', using the mover's
+    // society probabilities when the adaptive operator is enabled
+    void move_towards(int mover, int guide) {
+        const bool adaptive = m_adaptive_operators && !society_probs.empty() && assignments[mover] >= 0;
+        const RegionProbs& probs = adaptive ? society_probs[assignments[mover]] : FIXED_REGION_PROBS;
+
+        double* x = position(mover);
+        const double* target = position(guide);
+        for (int j = 0; j < n_variables; ++j) {
+            int region;
+            x[j] = acquire_information(
+                x[j],
+                target[j],
+                lower_bounds[j],
+                upper_bounds[j],
+                probs, region
+            );
+            if (adaptive) region_uses[mover][region]++;
+        }
+        if (m_bandit && (int)moved.size() == m_pop_size) moved[mover] = 1;
+    }
+
+    // Nearest member of 'targets' to individual 'index' (exact, first on ties)
+    int nearest_exact(int index, const std::vector<int>& targets) {
+        int nearest = -1;
+        double min_dist = std::numeric_limits<double>::max();
+
+        for (int target : targets) {
+            double d = distance_at(index, target);
+            if (d < min_dist) {
+                min_dist = d;
+                nearest = target;
+            }
+        }
+        return nearest;
+    }
+
+    // nearest_exact() plus search statistics
+    int find_nearest(int index, const std::vector<int>& targets) {
+        nearest_stats.queries++;
+        nearest_stats.distance_evals += targets.size();
+        return nearest_exact(index, targets);
+    }
+
+    // Nearest member of 'targets' for every entry of 'queries', through the LSH
+    // index when the target set is large enough. Targets must not move while
+    // the answers are used (leaders in Step 4, super leaders in Step 7).
+    std::vector<int> nearest_targets(const std::vector<int>& queries, const std::vector<int>& targets) {
+        std::vector<int> nearest(queries.size(), -1);
+        if (targets.empty()) return nearest;
+
+        const bool approximate = m_lsh && n_variables >= m_lsh_min_dims &&
+            (int)targets.size() >= m_lsh_min_targets;
+        if (!approximate) {
+            for (size_t q = 0; q < queries.size(); ++q) nearest[q] = find_nearest(queries[q], targets);
+            return nearest;
+        }
+
+        // Bucket width from the spread of the target set
+        std::uniform_int_distribution<int> pick(0, static_cast<int>(targets.size()) - 1);
+        std::vector<double> sample;
+        for (int k = 0; k < 32; ++k) {
+            int a = targets[pick(lsh_rng)], b = targets[pick(lsh_rng)];
+            if (a != b) sample.push_back(distance_at(a, b));
+        }
+        double width = 1.0;
+        if (!sample.empty()) {
+            std::nth_element(sample.begin(), sample.begin() + sample.size() / 2, sample.end());
+            width = std::max(m_lsh_width_scale * sample[sample.size() / 2], 1e-12);
+        }
+
+        std::vector<const double*> points(targets.size());
+        for (size_t t = 0; t < targets.size(); ++t) points[t] = position(targets[t]);
+        lsh_index.build(points, width, m_lsh_tables);
+
+        for (size_t q = 0; q < queries.size(); ++q) {
+            // Recall below target even at max tables: the index is only probed
+            if (m_lsh_below_target) {
+                nearest_stats.exact_fallbacks++;
+                nearest[q] = find_nearest(queries[q], targets);
+                continue;
+            }
+            int hit = lsh_index.query(position(queries[q]), &nearest_stats.distance_evals);
+            if (hit >= 0) {
+                nearest_stats.queries++;
+                nearest_stats.approximate++;
+                nearest[q] = targets[hit];
+            }
+            else {
+                nearest_stats.exact_fallbacks++;
+                nearest[q] = find_nearest(queries[q], targets);
+            }
+        }
+
+        // Re-check a few answers exactly and adapt the number of tables
+        std::uniform_int_distribution<int> pick_query(0, static_cast<int>(queries.size()) - 1);
+        const int probes = std::min<int>(4, static_cast<int>(queries.size()));
+        for (int k = 0; k < probes; ++k) {
+            // Probes are diagnostics, so they are not counted as search cost
+            size_t q = static_cast<size_t>(pick_query(lsh_rng));
+            int exact = nearest_exact(queries[q], targets);
+            int answer = nearest[q];
+            if (m_lsh_below_target) {
+                // What LSH would have answered (no bucket matched: exact, as above)
+                int found = lsh_index.query(position(queries[q]), nullptr);
+                answer = found >= 0 ? targets[found] : exact;
+            }
+            bool hit = distance_at(queries[q], exact) >= distance_at(queries[q], answer);
+            nearest_stats.probes++;
+            m_lsh_window_probes++;
+            if (hit) {
+                nearest_stats.probe_hits++;
+                m_lsh_window_hits++;
+            }
+        }
+        // A window of 32 probes; it closes early once it has more misses than
+        // a window at the target may have, so low recall is acted on quickly
+        const int WINDOW = 32;
+        const int misses = m_lsh_window_probes - m_lsh_window_hits;
+        const bool missed_target = misses > (1.0 - m_lsh_recall_target) * WINDOW;
+        if (missed_target || m_lsh_window_probes >= WINDOW) {
+            const double recall = missed_target ? 0.0 : static_cast<double>(m_lsh_window_hits) / m_lsh_window_probes;
+            m_lsh_below_target = recall < m_lsh_recall_target && m_lsh_tables == lsh_index.max_tables();
+            if (recall < m_lsh_recall_target) m_lsh_tables = std::min(m_lsh_tables * 2, lsh_index.max_tables());
+            else if (recall > m_lsh_recall_target + 0.5 * (1.0 - m_lsh_recall_target)) m_lsh_tables = std::max(m_lsh_tables - 1, 1);
+            m_lsh_window_probes = m_lsh_window_hits = 0;
+        }
+        return nearest;
+    }
+
+    // Evaluation bandit: marks in move_chosen the followers that move in
+    // Step 4, a random bandit_quota[s] of those of each society s
+    void allocate_moves() {
+        const int num_societies = static_cast<int>(societies.size());
+        if ((int)bandit_gain.size() != m_pop_size) bandit_gain.assign(m_pop_size, 1.0);
+        move_chosen.assign(m_pop_size, 0);
+        bandit_quota.assign(num_societies, 0);
+        bandit_score.assign(num_societies, 0.0);
+
+        // Minimum share first
+        int followers = 0, granted = 0;
+        for (int s = 0; s < num_societies; ++s) {
+            const std::vector<int>& members = societies[s];
+            if (members.empty() || society_leaders[s].empty()) continue;
+            const int f = static_cast<int>(members.size() - society_leaders[s].size());
+            double sum = 0.0;
+            for (int i : members) sum += bandit_gain[i];
+            bandit_score[s] = sum / members.size();
+            if (f == 0) continue;
+            bandit_quota[s] = std::min(f, std::max(1, static_cast<int>(std::ceil(m_bandit_min_share * f))));
+            followers += f;
+            granted += bandit_quota[s];
+        }
+
+        // The rest of the budget in proportion to score x spare followers
+        // (to spare followers alone while no society improves)
+        const int budget = static_cast<int>(std::ceil(m_bandit_budget * followers));
+        auto spare = [&](int s) {
+            if (societies[s].empty() || society_leaders[s].empty()) return 0;
+            return static_cast<int>(societies[s].size() - society_leaders[s].size()) - bandit_quota[s];
+        };
+        int left = budget - granted;
+        if (left > 0) {
+            double total = 0.0, total_spare = 0.0;
+            for (int s = 0; s < num_societies; ++s) {
+                total += bandit_score[s] * spare(s);
+                total_spare += spare(s);
+            }
+            const bool by_score = total > 0.0;
+            const int share_of = left;
+            for (int s = 0; s < num_societies; ++s) {
+                const double w = by_score ? bandit_score[s] * spare(s) / total : spare(s) / total_spare;
+                const int extra = std::min(spare(s), static_cast<int>(std::floor(share_of * w)));
+                bandit_quota[s] += extra;
+                left -= extra;
+            }
+            // Rounding leftovers: one more per society, best score first
+            bandit_order.resize(num_societies);
+            for (int s = 0; s < num_societies; ++s) bandit_order[s] = s;
+            std::stable_sort(bandit_order.begin(), bandit_order.end(),
+                [this](int a, int b) { return bandit_score[a] > bandit_score[b]; });
+            while (left > 0) {
+                bool granted_any = false;
+                for (int s : bandit_order) {
+                    if (left == 0) break;
+                    if (spare(s) == 0) continue;
+                    bandit_quota[s]++;
+                    left--;
+                    granted_any = true;
+                }
+                if (!granted_any) break;
+            }
+        }
+
+        // A random subset of each society's followers
+        for (int s = 0; s < num_societies; ++s) {
+            if (bandit_quota[s] == 0) continue;
+            bandit_pool.clear();
+            for (int i : societies[s]) {
+                if (!is_leader(i)) bandit_pool.push_back(i);
+            }
+            const int quota = bandit_quota[s];
+            for (int k = 0; k < quota; ++k) {
+                std::uniform_int_distribution<int> pick(k, static_cast<int>(bandit_pool.size()) - 1);
+                std::swap(bandit_pool[k], bandit_pool[pick(rng)]);
+                move_chosen[bandit_pool[k]] = 1;
+            }
+            bandit_stats.moved += quota;
+            bandit_stats.frozen += static_cast<long long>(bandit_pool.size()) - quota;
+        }
+    }
+
     // Step 4: Intra-Society Interaction
     void move_society_members() {
+        // With approximate search the nearest leaders are resolved per society
+        // up front; leaders do not move in this step, so the answers are the
+        // same as when searching inside the loop.
+        if (m_track_influence) influence.assign(m_pop_size, -1);
+        if (m_bandit) allocate_moves();
+        std::vector<int> nearest_of;
+        if (m_lsh) {
+            nearest_of.assign(m_pop_size, -1);
+            std::vector<std::vector<int>> followers(society_leaders.size());
+            for (int i = 0; i < m_pop_size; ++i) {
+                if (assignments[i] >= 0 && !is_leader(i) && (!m_bandit || move_chosen[i])) followers[assignments[i]].push_back(i);
+            }
+            for (size_t s = 0; s < followers.size(); ++s) {
+                std::vector<int> found = nearest_targets(followers[s], society_leaders[s]);
+                for (size_t q = 0; q < found.size(); ++q) nearest_of[followers[s][q]] = found[q];
+            }
+        }
+
         for (int i = 0; i < m_pop_size; ++i) {
-            // Leaders do not move in this step
+            // Leaders do not move in this step, nor followers the bandit froze
             if (is_leader(i)) continue;
+            if (m_bandit && !move_chosen[i]) continue;
 
             int society_id = assignments[i];
             if (society_id == -1 || society_leaders[society_id].empty()) continue;
 
             // Find nearest leader in the same society
-            int nearest_leader = -1;
-            double min_dist = std::numeric_limits<double>::max();
-
-            for (int leader_idx : society_leaders[society_id]) {
-                double d = calculate_distance(population[i], population[leader_idx]);
-                if (d < min_dist) {
-                    min_dist = d;
-                    nearest_leader = leader_idx;
-                }
-            }
+            int nearest_leader = m_lsh ? nearest_of[i] : find_nearest(i, society_leaders[society_id]);
 
             // Apply Information Acquisition Operator for each variable
-            if (nearest_leader != -1) {
-                for (int j = 0; j < n_variables; ++j) {
-                    population[i].variables[j] = acquire_information(
-                        population[i].variables[j],
-                        population[nearest_leader].variables[j],
-                        lower_bounds[j],
-                        upper_bounds[j]
-                    );
-                }
-            }
+            if (nearest_leader != -1) move_towards(i, nearest_leader);
+            if (m_track_influence) influence[i] = nearest_leader;
         }
         //std::cout << "--> Step 4: Society members moved towards leaders.\n";
     }
@@ -365,31 +1915,8 @@ public:
         rank_society(global_society);
 
         // 2. Filter for Super Leaders (Same logic as Step 3)
-        std::vector<int> rank1;
-        double sum_obj = 0.0;
-
-        for (int idx : global_society) {
-            sum_obj += population[idx].objective_value;
-            if (population[idx].rank == 1) rank1.push_back(idx);
-        }
-
-        double avg_obj = (global_society.size() > 0) ? sum_obj / global_society.size() : 0.0;
-
-        // Selection Logic
-        bool filter = rank1.size() > (global_society.size() * 0.5);
-
-        if (!filter) {
-            super_leaders = rank1;
-        }
-        else {
-            for (int idx : rank1) {
-                if (population[idx].objective_value <= avg_obj)
-                    super_leaders.push_back(idx);
-            }
-            // Fallback
-            if (super_leaders.empty() && !rank1.empty())
-                super_leaders.push_back(rank1[0]);
-        }
+        select_leaders(global_society, super_leaders);
+        if (m_max_super_leaders > 0) cap_leaders(super_leaders, m_max_super_leaders);
 
         //std::cout << "--> Step 6: Identified " << super_leaders.size() << " Super Leaders.\n";
     }
@@ -406,8 +1933,8 @@ public:
         for (int i = 0; i < GRID; ++i) for (int j = 0; j < GRID; ++j) grid[i][j] = '.';
 
         for (int i = 0; i < m_pop_size; ++i) {
-            double x = (population[i].variables[0] - lower_bounds[0]) / (upper_bounds[0] - lower_bounds[0]);
-            double y = (population[i].variables[1] - lower_bounds[1]) / (upper_bounds[1] - lower_bounds[1]);
+            double x = (position(i)[0] - lower_bounds[0]) / (upper_bounds[0] - lower_bounds[0]);
+            double y = (position(i)[1] - lower_bounds[1]) / (upper_bounds[1] - lower_bounds[1]);
             int c = (int)(x * (GRID - 1));
             int r = (int)(y * (GRID - 1));
             r = (GRID - 1) - r;
@@ -452,33 +1979,23 @@ public:
     void move_global_leaders() {
         if (super_leaders.empty()) return;
 
+        movers.clear();
         for (int leader_idx : global_society) {
             // Step 8: Super leaders do not change position
-            if (is_super_leader(leader_idx)) continue;
+            if (!is_super_leader(leader_idx)) movers.push_back(leader_idx);
+        }
+        std::vector<int> nearest_of;
+        if (m_lsh) nearest_of = nearest_targets(movers, super_leaders);
+
+        for (size_t k = 0; k < movers.size(); ++k) {
+            const int leader_idx = movers[k];
 
             // Find closest Super Leader
-            int nearest_super = -1;
-            double min_dist = std::numeric_limits<double>::max();
-
-            for (int super_idx : super_leaders) {
-                double d = calculate_distance(population[leader_idx], population[super_idx]);
-                if (d < min_dist) {
-                    min_dist = d;
-                    nearest_super = super_idx;
-                }
-            }
+            int nearest_super = m_lsh ? nearest_of[k] : find_nearest(leader_idx, super_leaders);
 
             // Apply Information Acquisition Operator
-            if (nearest_super != -1) {
-                for (int j = 0; j < n_variables; ++j) {
-                    population[leader_idx].variables[j] = acquire_information(
-                        population[leader_idx].variables[j],
-                        population[nearest_super].variables[j],
-                        lower_bounds[j],
-                        upper_bounds[j]
-                    );
-                }
-            }
+            if (nearest_super != -1) move_towards(leader_idx, nearest_super);
+            if (m_track_influence && (int)influence.size() == m_pop_size) influence[leader_idx] = nearest_super;
         }
         //std::cout << "--> Step 7: Global Leaders moved towards Super Leaders.\n";
     }
@@ -502,12 +2019,12 @@ public:
             // Check Super Leader
             for (int s : super_leaders) if (s == i) is_super = 1;
 
-            file << population[i].variables[0] << ","
-                << population[i].variables[1] << ","
+            file << position(i)[0] << ","
+                << position(i)[1] << ","
                 << assignments[i] << ","
                 << is_leader << ","
                 << is_super << ","
-                << population[i].objective_value << "\n";
+                << objective_at(i) << "\n";
         }
         file.close();
         std::cout << "Data exported to " << filename << std::endl;
@@ -530,12 +2047,16 @@ public:
     void print_population_sample(int count = 5) {
         for (int i = 0; i < std::min(count, m_pop_size); ++i) {
             std::cout << "Individual " << i << ": [ ";
-            for (double val : population[i].variables) std::cout << val << " ";
+            for (int j = 0; j < n_variables; ++j) std::cout << position(i)[j] << " ";
             std::cout << "]" << std::endl;
         }
     }
 
-    std::vector<Individual>& get_population() { return population; }
+    // Not available out of core (see get_individual())
+    std::vector<Individual>& get_population() {
+        if (storage) throw std::logic_error("get_population(): the population is out of core");
+        return population;
+    }
 
     //// --- Helper: Get Best Solution (Post-Simulation) ---
     //Individual get_best_solution() {
@@ -602,30 +2123,22 @@ public:
     //}
 
     Individual get_best_solution() {
-        constexpr double FEAS_EPS = 1e-12;
-
-        if (population.empty() || m_pop_size <= 0) {
+        if (population_count() == 0 || m_pop_size <= 0) {
             throw std::runtime_error("get_best_solution(): empty population");
         }
 
-        auto violation_sum = [](const Individual& ind) {
-            double s = 0.0;
-            for (double v : ind.constraint_violations) s += v;
-            return s;
-        };
-
         // 1) Best feasible (violation sum ~ 0), then lowest objective
         int best_idx = -1;
         for (int i = 0; i < m_pop_size; ++i) {
-            const double v = violation_sum(population[i]);
+            const double v = violation_sum_at(i);
             if (v <= FEAS_EPS) {
                 if (best_idx == -1 ||
-                    population[i].objective_value < population[best_idx].objective_value) {
+                    objective_at(i) < objective_at(best_idx)) {
                     best_idx = i;
                 }
             }
         }
-        if (best_idx != -1) return population[best_idx];
+        if (best_idx != -1) return get_individual(best_idx);
 
         // 2) No feasible: pick best among rank-1 in constraint space (as per papers constraint-Pareto concept),
         // then lowest objective, tie-break by lower violation sum.
@@ -636,7 +2149,7 @@ public:
             bool dominated = false;
             for (int j = 0; j < m_pop_size; ++j) {
                 if (i == j) continue;
-                if (dominates(population[j], population[i])) { // constraint dominance
+                if (dominates_at(j, i)) { // constraint dominance
                     dominated = true;
                     break;
                 }
@@ -648,33 +2161,34 @@ public:
             // Extremely defensive fallback: choose minimum violation sum, then objective
             best_idx = 0;
             for (int i = 1; i < m_pop_size; ++i) {
-                const double vi = violation_sum(population[i]);
-                const double vb = violation_sum(population[best_idx]);
-                if (vi < vb || (vi == vb && population[i].objective_value < population[best_idx].objective_value)) {
+                const double vi = violation_sum_at(i);
+                const double vb = violation_sum_at(best_idx);
+                if (vi < vb || (vi == vb && objective_at(i) < objective_at(best_idx))) {
                     best_idx = i;
                 }
             }
-            return population[best_idx];
+            return get_individual(best_idx);
         }
 
         best_idx = rank1[0];
         for (int idx : rank1) {
-            if (population[idx].objective_value < population[best_idx].objective_value) {
+            if (objective_at(idx) < objective_at(best_idx)) {
                 best_idx = idx;
             }
-            else if (population[idx].objective_value == population[best_idx].objective_value) {
-                if (violation_sum(population[idx]) < violation_sum(population[best_idx])) {
+            else if (objective_at(idx) == objective_at(best_idx)) {
+                if (violation_sum_at(idx) < violation_sum_at(best_idx)) {
                     best_idx = idx;
                 }
             }
         }
 
-        return population[best_idx];
+        return get_individual(best_idx);
     }
 
     // Data Logging for Animation/Analysis ---
     // Appends the current state of the entire population to an open CSV stream
-    void log_state(std::ofstream& file, int run, int time_step) {
+    // (with influence tracking, each row ends with an InfluencedBy column)
+    void log_state(std::ostream& file, int run, int time_step) {
         if (assignments.empty()) return;
 
         for (int i = 0; i < m_pop_size; ++i) {
@@ -698,12 +2212,14 @@ public:
             file << run << ","
                 << time_step << ","
                 << i << "," // Individual ID (to track specific agents over time)
-                << population[i].variables[0] << ","
-                << population[i].variables[1] << ","
-                << population[i].objective_value << ","
+                << position(i)[0] << ","
+                << position(i)[1] << ","
+                << objective_at(i) << ","
                 << assignments[i] << ","
                 << is_local_leader << ","
-                << is_super_leader << "\n";
+                << is_super_leader;
+            if (m_track_influence) file << "," << ((int)influence.size() == m_pop_size ? influence[i] : -1);
+            file << "\n";
         }
     }
 };
\ No newline at end of file
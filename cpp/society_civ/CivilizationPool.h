@@ -0,0 +1,74 @@
+#pragma once
+#include "Civilization.h"
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Engines kept across runs of a study. A run takes an idle engine (or has the
+// factory build one), reseeds it and gives it back when done, so a study with
+// thousands of short runs builds only as many civilizations as ran at once.
+class CivilizationPool {
+public:
+    // Builds an engine with the study's problem and options (any seed)
+    using Factory = std::function<std::unique_ptr<Civilization>()>;
+
+    // RAII handle on one engine; returns it to the pool on destruction
+    class Lease {
+    public:
+        Lease(CivilizationPool& pool, std::unique_ptr<Civilization> civ) : m_pool(&pool), m_civ(std::move(civ)) {}
+        ~Lease() {
+            if (m_civ) m_pool->give_back(std::move(m_civ));
+        }
+        Lease(Lease&& other) noexcept : m_pool(other.m_pool), m_civ(std::move(other.m_civ)) {}
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        Lease& operator=(Lease&&) = delete;
+
+        Civilization& operator*() const { return *m_civ; }
+        Civilization* operator->() const { return m_civ.get(); }
+
+    private:
+        CivilizationPool* m_pool;
+        std::unique_ptr<Civilization> m_civ;
+    };
+
+    explicit CivilizationPool(Factory factory) : m_factory(std::move(factory)) {}
+
+    // An engine reseeded with 'seed' (initialize() already done)
+    Lease acquire(unsigned int seed) {
+        std::unique_ptr<Civilization> civ;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_idle.empty()) {
+                civ = std::move(m_idle.back());
+                m_idle.pop_back();
+            }
+        }
+        if (!civ) {
+            civ = m_factory();
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_created++;
+        }
+        civ->reseed(seed);
+        return Lease(*this, std::move(civ));
+    }
+
+    // Engines built so far (the peak number of concurrent runs)
+    int created() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_created;
+    }
+
+private:
+    Factory m_factory;
+    mutable std::mutex m_mutex;
+    std::vector<std::unique_ptr<Civilization>> m_idle;
+    int m_created = 0;
+
+    void give_back(std::unique_ptr<Civilization> civ) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_idle.push_back(std::move(civ));
+    }
+};
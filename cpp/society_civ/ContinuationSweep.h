@@ -0,0 +1,188 @@
+#pragma once
+#include "Civilization.h"
+#include "TaskRuntime.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+// Solves sequences of related problem instances, e.g. the welded beam over a
+// range of loads, by continuation: each instance starts from the previous
+// one's solution instead of from scratch.
+//
+// A sweep is a list of branches; the instances of a branch are solved in
+// order by one engine, branches run in parallel on the shared TaskRuntime.
+// With warm starts, part of the population of instance k+1 is placed at
+//   - the elite archive: best-ever solutions of the last few instances,
+//   - the local leaders of the final societies of instance k (one or more
+//     per basin the search had found),
+//   - the rest of the final population of instance k, best first,
+// and the remainder is drawn at random as usual. An instance is solved once
+// its best-ever solution stops improving (see Options), so a warm start pays
+// off as fewer steps to the same answer.
+class ContinuationSweep {
+public:
+    struct Instance {
+        std::string label;
+        Civilization::ObjFunc objective;
+        Civilization::ConFunc constraints;
+    };
+    using Branch = std::vector<Instance>;
+
+    struct Options {
+        int pop_size = 100;
+        int min_steps = 10;
+        int max_steps = 300;
+        int patience = 20;           // steps without a significant improvement before an instance counts as solved
+        double tolerance = 1e-4;     // significant: relative objective gain above this, or a less infeasible best
+        bool warm_start = true;      // false: every instance from scratch (the baseline)
+        double carry_fraction = 0.5; // share of the population placed from the previous instance
+        int archive_size = 5;        // best-ever solutions kept across the instances of a branch
+        unsigned seed = 1;
+    };
+
+    struct Result {
+        int branch = 0;
+        int index = 0;             // position in the branch
+        std::string label;
+        Individual best = Individual(0);
+        long long evaluations = 0;
+        int steps = 0;
+        bool warm = false;         // started from the previous instance
+    };
+
+    ContinuationSweep(int num_vars, std::vector<double> lb, std::vector<double> ub, const Options& options)
+        : n_variables(num_vars), lower_bounds(std::move(lb)), upper_bounds(std::move(ub)), m_options(options) {}
+
+    const Options& options() const { return m_options; }
+
+    // Results ordered by branch, then by position in the branch
+    std::vector<Result> solve(const std::vector<Branch>& branches) const {
+        std::vector<std::vector<Result>> per_branch(branches.size());
+        TaskRuntime::instance().parallel_for_dynamic(0, static_cast<int>(branches.size()), [&](int b) {
+            solve_branch(b, branches[b], per_branch[b]);
+        });
+
+        std::vector<Result> results;
+        for (auto& r : per_branch) results.insert(results.end(), r.begin(), r.end());
+        return results;
+    }
+
+    // Seed of instance 'index' of branch 'branch' (the same warm or cold)
+    unsigned seed_of(int branch, int index) const {
+        return m_options.seed + 7919u * static_cast<unsigned>(branch) + static_cast<unsigned>(index);
+    }
+
+private:
+    int n_variables;
+    std::vector<double> lower_bounds;
+    std::vector<double> upper_bounds;
+    Options m_options;
+
+    void solve_branch(int b, const Branch& branch, std::vector<Result>& out) const {
+        if (branch.empty()) return;
+        Civilization civ(m_options.pop_size, n_variables, lower_bounds, upper_bounds,
+            branch[0].objective, branch[0].constraints, seed_of(b, 0));
+        civ.set_verbose(false);
+
+        std::vector<Individual> archive; // most recent instance first
+        std::vector<std::vector<double>> carried;
+        for (int k = 0; k < (int)branch.size(); ++k) {
+            civ.set_problem(branch[k].objective, branch[k].constraints);
+            civ.reseed(seed_of(b, k));
+            const bool warm = m_options.warm_start && !carried.empty();
+            if (warm) civ.seed_positions(carried);
+
+            Result r;
+            r.branch = b;
+            r.index = k;
+            r.label = branch[k].label;
+            r.warm = warm;
+            r.steps = run_to_stagnation(civ);
+            r.evaluations = civ.evaluations();
+            r.best = civ.get_best_ever();
+            out.push_back(r);
+
+            if (m_options.warm_start) {
+                archive.insert(archive.begin(), r.best);
+                while ((int)archive.size() > std::max(0, m_options.archive_size)) archive.pop_back();
+                carried = carry_over(civ, archive);
+            }
+        }
+    }
+
+    // Steps until the best-ever solution has not improved significantly for
+    // 'patience' steps (at least min_steps, at most max_steps).
+    // Each step is Civilization::step() split after its evaluation: the
+    // moves of the final step are left out, so the population, societies and
+    // leaders carry_over() reads are the ones that were just evaluated.
+    int run_to_stagnation(Civilization& civ) const {
+        Individual incumbent(0);
+        bool has_incumbent = false;
+        int since = 0, steps = 0;
+        while (steps < m_options.max_steps) {
+            civ.cluster_population();
+            civ.identify_leaders();
+            steps++;
+            since++;
+            if (civ.has_best_ever() && (!has_incumbent || significant(civ.get_best_ever(), incumbent))) {
+                incumbent = civ.get_best_ever();
+                has_incumbent = true;
+                since = 0;
+            }
+            if (steps >= m_options.max_steps || (steps >= m_options.min_steps && since >= m_options.patience)) break;
+
+            civ.move_society_members();
+            civ.form_global_society();
+            civ.identify_super_leaders();
+            civ.move_global_leaders();
+        }
+        return steps;
+    }
+
+    bool significant(const Individual& candidate, const Individual& incumbent) const {
+        if (!Civilization::is_better_solution(candidate, incumbent)) return false;
+        const double vc = Civilization::violation_sum(candidate);
+        const double vi = Civilization::violation_sum(incumbent);
+        if (vi > Civilization::FEAS_EPS) return vc <= Civilization::FEAS_EPS || vi - vc > m_options.tolerance * vi;
+        return incumbent.objective_value - candidate.objective_value >
+            m_options.tolerance * std::max(1.0, std::abs(incumbent.objective_value));
+    }
+
+    // Positions that start the next instance: archive, local leaders, then
+    // the rest of the final population best first, all as last evaluated
+    // (see run_to_stagnation())
+    std::vector<std::vector<double>> carry_over(Civilization& civ, const std::vector<Individual>& archive) const {
+        const int budget = static_cast<int>(m_options.carry_fraction * m_options.pop_size);
+        std::vector<std::vector<double>> positions;
+        for (const Individual& elite : archive) {
+            if ((int)positions.size() >= budget) return positions;
+            positions.push_back(elite.variables);
+        }
+
+        std::vector<Individual>& population = civ.get_population();
+        std::vector<char> taken(population.size(), 0);
+        for (const auto& leaders : civ.get_society_leaders()) {
+            for (int idx : leaders) {
+                if ((int)positions.size() >= budget) return positions;
+                if (taken[idx]) continue;
+                taken[idx] = 1;
+                positions.push_back(population[idx].variables);
+            }
+        }
+
+        std::vector<int> order;
+        for (int i = 0; i < (int)population.size(); ++i) {
+            if (!taken[i]) order.push_back(i);
+        }
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+            return Civilization::is_better_solution(population[a], population[b]);
+        });
+        for (int idx : order) {
+            if ((int)positions.size() >= budget) break;
+            positions.push_back(population[idx].variables);
+        }
+        return positions;
+    }
+};
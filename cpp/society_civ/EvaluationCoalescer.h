@@ -0,0 +1,168 @@
+#pragma once
+#include "Individual.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Gathers the batch evaluations of concurrent civilizations (runs, islands)
+// into one large batch for a vectorized or service-based evaluator.
+//
+// Each civilization gets its own evaluator from client() and passes it to
+// Civilization::set_batch_evaluator(). A call blocks until its designs are
+// evaluated. The first caller of a round gathers: the round is dispatched
+// once every live client is waiting, once 'max_batch' designs are pending, or
+// 'max_wait' after it opened, whichever comes first. The combined batch goes
+// to the inner evaluator in one call, from one thread at a time, and every
+// caller returns with its own designs filled in (an exception thrown by the
+// inner evaluator is rethrown to every caller of that round).
+//
+// Each design's values depend only on the design, so every run gets the
+// results it would get on its own, whatever it was batched with. Runs that
+// share a coalescer should each have a thread of their own; otherwise rounds
+// close on 'max_wait' alone.
+class EvaluationCoalescer {
+public:
+    using BatchFunc = std::function<void(const std::vector<Individual*>&)>;
+
+    struct Options {
+        size_t max_batch = 4096;                        // dispatch once this many designs are pending
+        std::chrono::microseconds max_wait{ 2000 };     // longest a round stays open
+    };
+
+    struct Stats {
+        long long requests = 0;    // client calls
+        long long dispatches = 0;  // calls of the inner evaluator
+        long long designs = 0;
+        size_t largest_batch = 0;
+        long long full_rounds = 0;    // closed because every client was waiting
+        long long timed_out_rounds = 0; // closed by max_wait
+    };
+
+    EvaluationCoalescer(BatchFunc inner, const Options& options)
+        : m_inner(std::move(inner)), m_options(options), m_state(std::make_shared<State>()) {}
+    explicit EvaluationCoalescer(BatchFunc inner) : EvaluationCoalescer(std::move(inner), Options()) {}
+
+    // An evaluator for one civilization. The client counts as live (its
+    // round waits for it) until the last copy of the function is destroyed;
+    // the coalescer must outlive it.
+    BatchFunc client() {
+        std::shared_ptr<State> state = m_state;
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->clients++;
+        }
+        std::shared_ptr<Membership> membership(new Membership{ state });
+        return [this, membership](const std::vector<Individual*>& batch) {
+            (void)membership;
+            evaluate(batch);
+        };
+    }
+
+    // Evaluates 'batch' as part of the current round (thread-safe)
+    void evaluate(const std::vector<Individual*>& batch) {
+        State& s = *m_state;
+        Request request{ &batch, false, nullptr };
+        std::unique_lock<std::mutex> lock(s.mutex);
+        s.stats.requests++;
+        s.pending.push_back(&request);
+        s.pending_designs += batch.size();
+        s.changed.notify_all();
+
+        while (!request.done) {
+            if (s.gathering) {
+                s.changed.wait(lock);
+                continue;
+            }
+            gather_and_dispatch(lock);
+        }
+        if (request.error) std::rethrow_exception(request.error);
+    }
+
+    Stats stats() const {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        return m_state->stats;
+    }
+
+    const Options& options() const { return m_options; }
+
+private:
+    struct Request {
+        const std::vector<Individual*>* batch;
+        bool done;
+        std::exception_ptr error;
+    };
+
+    struct State {
+        mutable std::mutex mutex;
+        std::condition_variable changed;
+        std::vector<Request*> pending;
+        size_t pending_designs = 0;
+        int clients = 0;
+        bool gathering = false; // a caller is gathering or dispatching a round
+        Stats stats;
+    };
+
+    // Leaves the client count when a client() function goes away
+    struct Membership {
+        std::shared_ptr<State> state;
+        ~Membership() {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->clients--;
+            state->changed.notify_all();
+        }
+    };
+
+    BatchFunc m_inner;
+    Options m_options;
+    std::shared_ptr<State> m_state;
+
+    // Called with the lock held by a caller whose request is pending and no
+    // round is open; returns with the lock held and that round completed
+    void gather_and_dispatch(std::unique_lock<std::mutex>& lock) {
+        State& s = *m_state;
+        s.gathering = true;
+        const auto deadline = std::chrono::steady_clock::now() + m_options.max_wait;
+        bool timed_out = false;
+        while (s.pending_designs < m_options.max_batch && (int)s.pending.size() < s.clients) {
+            if (s.changed.wait_until(lock, deadline) == std::cv_status::timeout) {
+                timed_out = (int)s.pending.size() < s.clients && s.pending_designs < m_options.max_batch;
+                break;
+            }
+        }
+
+        std::vector<Request*> round;
+        round.swap(s.pending);
+        s.pending_designs = 0;
+        if (timed_out) s.stats.timed_out_rounds++;
+        else if ((int)round.size() >= s.clients) s.stats.full_rounds++;
+        lock.unlock();
+
+        // Requests arriving from here on wait for the next round
+        std::vector<Individual*> combined;
+        for (const Request* r : round) combined.insert(combined.end(), r->batch->begin(), r->batch->end());
+        std::exception_ptr error;
+        try {
+            if (!combined.empty()) m_inner(combined);
+        }
+        catch (...) {
+            error = std::current_exception();
+        }
+
+        lock.lock();
+        for (Request* r : round) {
+            r->error = error;
+            r->done = true;
+        }
+        s.stats.dispatches++;
+        s.stats.designs += static_cast<long long>(combined.size());
+        s.stats.largest_batch = std::max(s.stats.largest_batch, combined.size());
+        s.gathering = false;
+        s.changed.notify_all();
+    }
+};
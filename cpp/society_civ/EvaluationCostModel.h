@@ -0,0 +1,121 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <vector>
+
+// Predicts the wall time of an evaluation from the design vector, using a
+// bounded history of recent (variables, seconds) measurements.
+//
+// NEAREST_NEIGHBOUR returns the cost of the closest recorded design (distance
+// in variables normalised by the bounds). LINEAR fits cost ~ w0 + w.x by ridge
+// least squares, refitted once per batch; it is meant for small n.
+class EvaluationCostModel {
+public:
+    enum Kind { NONE = 0, NEAREST_NEIGHBOUR, LINEAR };
+
+    EvaluationCostModel() = default;
+
+    EvaluationCostModel(Kind kind, const std::vector<double>& lb, const std::vector<double>& ub, int history)
+        : m_kind(kind), lower_bounds(lb), upper_bounds(ub), m_history(std::max(1, history)) {}
+
+    Kind kind() const { return m_kind; }
+    bool empty() const { return samples.empty(); }
+
+    void record(const std::vector<double>& variables, double seconds) {
+        samples.push_back({ normalise(variables), seconds });
+        if ((int)samples.size() > m_history) samples.pop_front();
+        m_dirty = true;
+    }
+
+    // Call once before a batch of predict() calls
+    void refit() {
+        if (m_kind != LINEAR || !m_dirty || samples.empty()) return;
+        m_dirty = false;
+
+        const size_t dim = lower_bounds.size() + 1; // bias + variables
+        std::vector<double> A(dim * dim, 0.0), b(dim, 0.0);
+        std::vector<double> row(dim);
+        for (const auto& s : samples) {
+            row[0] = 1.0;
+            for (size_t j = 1; j < dim; ++j) row[j] = s.x[j - 1];
+            for (size_t r = 0; r < dim; ++r) {
+                b[r] += row[r] * s.cost;
+                for (size_t c = 0; c < dim; ++c) A[r * dim + c] += row[r] * row[c];
+            }
+        }
+        for (size_t r = 0; r < dim; ++r) A[r * dim + r] += 1e-9 + 1e-6 * A[r * dim + r]; // ridge
+
+        // Gaussian elimination with partial pivoting
+        for (size_t col = 0; col < dim; ++col) {
+            size_t pivot = col;
+            for (size_t r = col + 1; r < dim; ++r)
+                if (std::abs(A[r * dim + col]) > std::abs(A[pivot * dim + col])) pivot = r;
+            if (std::abs(A[pivot * dim + col]) < 1e-300) continue;
+            if (pivot != col) {
+                for (size_t c = 0; c < dim; ++c) std::swap(A[col * dim + c], A[pivot * dim + c]);
+                std::swap(b[col], b[pivot]);
+            }
+            for (size_t r = col + 1; r < dim; ++r) {
+                const double f = A[r * dim + col] / A[col * dim + col];
+                for (size_t c = col; c < dim; ++c) A[r * dim + c] -= f * A[col * dim + c];
+                b[r] -= f * b[col];
+            }
+        }
+        weights.assign(dim, 0.0);
+        for (size_t r = dim; r-- > 0;) {
+            if (std::abs(A[r * dim + r]) < 1e-300) continue;
+            double acc = b[r];
+            for (size_t c = r + 1; c < dim; ++c) acc -= A[r * dim + c] * weights[c];
+            weights[r] = acc / A[r * dim + r];
+        }
+    }
+
+    // Predicted seconds (0 without history)
+    double predict(const std::vector<double>& variables) const {
+        if (samples.empty() || m_kind == NONE) return 0.0;
+        const std::vector<double> x = normalise(variables);
+
+        if (m_kind == LINEAR && !weights.empty()) {
+            double cost = weights[0];
+            for (size_t j = 0; j < x.size(); ++j) cost += weights[j + 1] * x[j];
+            return std::max(cost, 0.0);
+        }
+
+        double best_d = std::numeric_limits<double>::max();
+        double cost = 0.0;
+        for (const auto& s : samples) {
+            double d = 0.0;
+            for (size_t j = 0; j < x.size(); ++j) {
+                const double diff = x[j] - s.x[j];
+                d += diff * diff;
+            }
+            if (d < best_d) { best_d = d; cost = s.cost; }
+        }
+        return cost;
+    }
+
+private:
+    struct Sample {
+        std::vector<double> x; // normalised variables
+        double cost;
+    };
+
+    Kind m_kind = NONE;
+    std::vector<double> lower_bounds;
+    std::vector<double> upper_bounds;
+    int m_history = 256;
+    std::deque<Sample> samples;
+    std::vector<double> weights;
+    bool m_dirty = false;
+
+    std::vector<double> normalise(const std::vector<double>& v) const {
+        std::vector<double> x(lower_bounds.size());
+        for (size_t j = 0; j < x.size() && j < v.size(); ++j) {
+            const double span = upper_bounds[j] - lower_bounds[j];
+            x[j] = span > 0.0 ? (v[j] - lower_bounds[j]) / span : 0.0;
+        }
+        return x;
+    }
+};
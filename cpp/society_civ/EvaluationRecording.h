@@ -0,0 +1,204 @@
+#pragma once
+#include "BlockWriter.h"
+#include "Individual.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Record and replay of evaluations, to benchmark the engine on a real
+// workload without the simulator behind it.
+//
+// EvaluationRecorder appends every evaluated design with its results
+// (Civilization::set_evaluation_recorder). EvaluationReplay loads such a
+// file into an in-memory table and serves the results back as a batch
+// evaluator: a run with the same seed and options asks for exactly the
+// recorded designs, so it takes the same path at memory speed. A design that
+// is not in the table means the run has diverged (other seed, options or
+// problem) and throws.
+//
+// File: the header, then one record per evaluation, all in host byte order:
+//   char magic[8] = "CIVEVAL1", int32 num_variables, int32 num_constraints
+//   record: num_variables doubles, objective, num_constraints violations
+// The header is written with the first record, when the constraint count is
+// known; a recording without evaluations is an empty file.
+namespace evaluation_recording {
+    constexpr char MAGIC[8] = { 'C', 'I', 'V', 'E', 'V', 'A', 'L', '1' };
+
+    // Hash of the exact bits of a design
+    inline uint64_t design_hash(const double* x, int n) {
+        uint64_t h = 1469598103934665603ull;
+        for (int j = 0; j < n; ++j) {
+            uint64_t bits;
+            std::memcpy(&bits, &x[j], sizeof(bits));
+            h ^= bits;
+            h *= 1099511628211ull;
+            h ^= h >> 29;
+        }
+        return h;
+    }
+}
+
+class EvaluationRecorder {
+public:
+    EvaluationRecorder(const std::string& path, int num_variables)
+        : m_path(path), m_variables(num_variables), m_writer(path) {}
+
+    // Appends 'ind' with its current results (thread-safe, so runs can share
+    // one recorder)
+    void record(const Individual& ind) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if ((int)ind.variables.size() != m_variables) {
+            throw std::invalid_argument("EvaluationRecorder: variable count mismatch");
+        }
+        const int32_t c = static_cast<int32_t>(ind.constraint_violations.size());
+        if (m_records == 0) {
+            const int32_t n = m_variables;
+            m_writer.write(evaluation_recording::MAGIC, sizeof(evaluation_recording::MAGIC));
+            m_writer.write(&n, sizeof(n));
+            m_writer.write(&c, sizeof(c));
+            m_constraints = c;
+        }
+        else if (c != m_constraints) {
+            throw std::runtime_error("EvaluationRecorder: constraint count changed between evaluations");
+        }
+        m_writer.write(ind.variables.data(), sizeof(double) * ind.variables.size());
+        m_writer.write(&ind.objective_value, sizeof(double));
+        m_writer.write(ind.constraint_violations.data(), sizeof(double) * ind.constraint_violations.size());
+        m_records++;
+    }
+
+    // Writes out buffered records; the file is complete after this
+    void close() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_writer.close();
+    }
+
+    long long records() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_records;
+    }
+    const std::string& path() const { return m_path; }
+
+private:
+    std::string m_path;
+    int m_variables;
+    int32_t m_constraints = 0;
+    long long m_records = 0;
+    BlockWriter m_writer;
+    mutable std::mutex m_mutex;
+};
+
+class EvaluationReplay {
+public:
+    explicit EvaluationReplay(const std::string& path) : m_path(path) {
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in) throw std::runtime_error("EvaluationReplay: cannot open '" + path + "'");
+        const std::streamoff size = in.tellg();
+        in.seekg(0);
+        if (size == 0) return;
+
+        char magic[sizeof(evaluation_recording::MAGIC)];
+        int32_t n = 0, c = 0;
+        in.read(magic, sizeof(magic));
+        in.read(reinterpret_cast<char*>(&n), sizeof(n));
+        in.read(reinterpret_cast<char*>(&c), sizeof(c));
+        if (!in || std::memcmp(magic, evaluation_recording::MAGIC, sizeof(magic)) != 0 || n <= 0 || c < 0) {
+            throw std::runtime_error("EvaluationReplay: '" + path + "' is not an evaluation recording");
+        }
+        m_variables = n;
+        m_constraints = c;
+
+        const std::streamoff header = static_cast<std::streamoff>(sizeof(magic) + 2 * sizeof(int32_t));
+        const size_t width = record_width();
+        const size_t count = static_cast<size_t>(size - header) / (sizeof(double) * width);
+        if (static_cast<std::streamoff>(count * sizeof(double) * width) != size - header) {
+            throw std::runtime_error("EvaluationReplay: '" + path + "' ends in a partial record");
+        }
+        m_table.resize(count * width);
+        in.read(reinterpret_cast<char*>(m_table.data()), static_cast<std::streamsize>(m_table.size() * sizeof(double)));
+        if (!in) throw std::runtime_error("EvaluationReplay: cannot read '" + path + "'");
+
+        // Index by design; a design evaluated more than once keeps its first
+        // record and its repeats stay out of the chain, which therefore only
+        // holds distinct designs (hash collisions) and grows at its tail
+        m_index.reserve(count);
+        m_next.assign(count, -1);
+        for (size_t r = 0; r < count; ++r) {
+            const uint64_t h = evaluation_recording::design_hash(record(r), m_variables);
+            auto found = m_index.find(h);
+            if (found == m_index.end()) {
+                m_index.emplace(h, Chain{ static_cast<int64_t>(r), static_cast<int64_t>(r) });
+                continue;
+            }
+            if (find_in_chain(found->second.first, record(r))) continue;
+            m_next[found->second.last] = static_cast<int64_t>(r);
+            found->second.last = static_cast<int64_t>(r);
+        }
+    }
+
+    // Fills in the recorded results of every design in 'batch' (thread-safe)
+    void evaluate(const std::vector<Individual*>& batch) const {
+        for (Individual* ind : batch) {
+            const double* r = find(*ind);
+            if (!r) {
+                m_misses++;
+                throw std::runtime_error("EvaluationReplay: design not in '" + m_path + "' (different seed, options or problem?)");
+            }
+            ind->objective_value = r[m_variables];
+            ind->constraint_violations.assign(r + m_variables + 1, r + m_variables + 1 + m_constraints);
+        }
+        m_lookups += static_cast<long long>(batch.size());
+    }
+
+    // A batch evaluator for Civilization::set_batch_evaluator(); the replay
+    // must outlive it
+    std::function<void(const std::vector<Individual*>&)> batch_evaluator() const {
+        return [this](const std::vector<Individual*>& batch) { evaluate(batch); };
+    }
+
+    size_t size() const { return m_next.size(); }
+    int num_variables() const { return m_variables; }
+    int num_constraints() const { return m_constraints; }
+    long long lookups() const { return m_lookups.load(); }
+    long long misses() const { return m_misses.load(); }
+
+private:
+    std::string m_path;
+    int m_variables = 0;
+    int m_constraints = 0;
+    struct Chain { int64_t first, last; };       // records with one design hash
+    std::vector<double> m_table;                 // records, record_width() doubles each
+    std::unordered_map<uint64_t, Chain> m_index; // design hash -> its chain
+    std::vector<int64_t> m_next;                 // next record with the same hash
+    mutable std::atomic<long long> m_lookups{ 0 };
+    mutable std::atomic<long long> m_misses{ 0 };
+
+    size_t record_width() const { return static_cast<size_t>(m_variables) + 1 + m_constraints; }
+    const double* record(size_t r) const { return m_table.data() + r * record_width(); }
+
+    // Record of design 'x' in the chain starting at 'first', or nullptr
+    const double* find_in_chain(int64_t first, const double* x) const {
+        for (int64_t r = first; r >= 0; r = m_next[r]) {
+            if (std::memcmp(record(static_cast<size_t>(r)), x, sizeof(double) * m_variables) == 0) {
+                return record(static_cast<size_t>(r));
+            }
+        }
+        return nullptr;
+    }
+
+    const double* find(const Individual& ind) const {
+        if ((int)ind.variables.size() != m_variables) return nullptr;
+        auto found = m_index.find(evaluation_recording::design_hash(ind.variables.data(), m_variables));
+        if (found == m_index.end()) return nullptr;
+        return find_in_chain(found->second.first, ind.variables.data());
+    }
+};
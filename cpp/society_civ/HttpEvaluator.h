@@ -0,0 +1,636 @@
+#pragma once
+#include "Individual.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "Ws2_32.lib")
+#else
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+// Wire format and socket helpers shared by HttpEvaluator and test servers.
+//
+// A request body carries a batch of design vectors, a response body the
+// objective and constraint violations of each, in the same order.
+//   application/octet-stream: int32 count, int32 width, then count * width
+//     IEEE-754 doubles, all little-endian. Requests: width = n. Responses:
+//     width = 1 + constraints, objective first.
+//   application/json: {"x":[[...],...]} and {"f":[...],"g":[[...],...]}
+namespace http_wire {
+
+#ifdef _WIN32
+using socket_t = SOCKET;
+const socket_t BAD_SOCKET = INVALID_SOCKET;
+inline void close_socket(socket_t s) { closesocket(s); }
+inline void startup() {
+    static const bool started = []() { WSADATA data; return WSAStartup(MAKEWORD(2, 2), &data) == 0; }();
+    (void)started;
+}
+#else
+using socket_t = int;
+const socket_t BAD_SOCKET = -1;
+inline void close_socket(socket_t s) { ::close(s); }
+inline void startup() {}
+#endif
+
+inline const char* content_type(bool binary) {
+    return binary ? "application/octet-stream" : "application/json";
+}
+
+inline bool send_all(socket_t s, const char* data, size_t length) {
+    while (length > 0) {
+#ifdef MSG_NOSIGNAL
+        const auto sent = ::send(s, data, static_cast<int>(length), MSG_NOSIGNAL);
+#else
+        const auto sent = ::send(s, data, static_cast<int>(length), 0);
+#endif
+        if (sent <= 0) return false;
+        data += sent;
+        length -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+// One HTTP/1.1 request or response
+struct Message {
+    std::string start_line; // "POST /path HTTP/1.1" or "HTTP/1.1 200 OK"
+    std::string content_type;
+    std::string body;
+    bool close = false;     // peer sent "Connection: close"
+    std::string error;      // why read_message failed on a message it did receive
+};
+
+// Reads one message; bytes of the next pipelined message stay in 'buffer'.
+// Bodies must be framed by Content-Length: a message without it, or with a
+// Transfer-Encoding (chunked), fails with 'error' set, and the connection is
+// out of step from then on. A plain connection failure leaves 'error' empty.
+inline bool read_message(socket_t s, std::string& buffer, Message& out) {
+    auto fill = [&]() {
+        char chunk[16384];
+        const auto got = ::recv(s, chunk, sizeof(chunk), 0);
+        if (got <= 0) return false;
+        buffer.append(chunk, static_cast<size_t>(got));
+        return true;
+    };
+
+    out = Message();
+    size_t header_end;
+    while ((header_end = buffer.find("\r\n\r\n")) == std::string::npos) {
+        if (buffer.size() > (1u << 16) || !fill()) return false;
+    }
+
+    size_t content_length = 0;
+    bool has_length = false;
+    size_t line_start = 0;
+    bool first = true;
+    while (line_start < header_end) {
+        size_t line_end = buffer.find("\r\n", line_start);
+        std::string line = buffer.substr(line_start, line_end - line_start);
+        line_start = line_end + 2;
+        if (first) {
+            out.start_line = line;
+            first = false;
+            continue;
+        }
+        const size_t colon = line.find(':');
+        if (colon == std::string::npos) continue;
+        std::string name = line.substr(0, colon);
+        std::string value = line.substr(colon + 1);
+        value.erase(0, value.find_first_not_of(' '));
+        value.erase(value.find_last_not_of(' ') + 1);
+        auto lower = [](std::string& text) {
+            std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        };
+        lower(name);
+        if (name == "content-length") {
+            char* end;
+            const size_t length = static_cast<size_t>(std::strtoull(value.c_str(), &end, 10));
+            if (value.empty() || !std::isdigit(static_cast<unsigned char>(value[0])) || *end != '\0' ||
+                (has_length && length != content_length)) {
+                out.error = "invalid Content-Length";
+                return false;
+            }
+            content_length = length;
+            has_length = true;
+        }
+        else if (name == "content-type") out.content_type = value;
+        else if (name == "connection") { lower(value); out.close = (value == "close"); }
+        else if (name == "transfer-encoding") {
+            lower(value);
+            if (value != "identity") {
+                out.error = "unsupported Transfer-Encoding: " + value;
+                return false;
+            }
+        }
+    }
+    if (!has_length) {
+        out.error = "missing Content-Length";
+        return false;
+    }
+
+    const size_t body_start = header_end + 4;
+    while (buffer.size() < body_start + content_length) {
+        if (!fill()) return false;
+    }
+    out.body = buffer.substr(body_start, content_length);
+    buffer.erase(0, body_start + content_length);
+    return true;
+}
+
+inline int status_code(const Message& response) {
+    const size_t space = response.start_line.find(' ');
+    return space == std::string::npos ? 0 : std::atoi(response.start_line.c_str() + space + 1);
+}
+
+// --- Binary payloads (little-endian whatever the host order) ---
+template <typename T, typename Bits>
+inline void append_le(std::string& out, T value) {
+    static_assert(sizeof(T) == sizeof(Bits), "append_le: size mismatch");
+    Bits bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    char bytes[sizeof(Bits)];
+    for (size_t i = 0; i < sizeof(Bits); ++i) bytes[i] = static_cast<char>((bits >> (8 * i)) & 0xff);
+    out.append(bytes, sizeof(bytes));
+}
+
+template <typename T, typename Bits>
+inline T read_le(const char* p) {
+    static_assert(sizeof(T) == sizeof(Bits), "read_le: size mismatch");
+    Bits bits = 0;
+    for (size_t i = 0; i < sizeof(Bits); ++i) bits |= static_cast<Bits>(static_cast<unsigned char>(p[i])) << (8 * i);
+    T value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+inline void append_double(std::string& out, double v) { append_le<double, uint64_t>(out, v); }
+
+inline void append_rows(std::string& out, int32_t count, int32_t width) {
+    append_le<int32_t, uint32_t>(out, count);
+    append_le<int32_t, uint32_t>(out, width);
+}
+
+inline bool read_rows_binary(const std::string& body, std::vector<std::vector<double>>& rows) {
+    if (body.size() < 2 * sizeof(int32_t)) return false;
+    const int32_t count = read_le<int32_t, uint32_t>(body.data());
+    const int32_t width = read_le<int32_t, uint32_t>(body.data() + sizeof(int32_t));
+    if (count < 0 || width < 0 ||
+        body.size() != 2 * sizeof(int32_t) + static_cast<size_t>(count) * width * sizeof(double)) return false;
+    const char* p = body.data() + 2 * sizeof(int32_t);
+    rows.assign(count, std::vector<double>(width));
+    for (auto& row : rows) {
+        for (double& v : row) {
+            v = read_le<double, uint64_t>(p);
+            p += sizeof(double);
+        }
+    }
+    return true;
+}
+
+// --- JSON payloads (just the two shapes above) ---
+inline void append_json_number(std::string& out, double v) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.17g", v);
+    out += text;
+}
+
+// Parses "[[a,b],[c,d]]" (or "[a,b]" when 'nested' is false, one row per value)
+inline bool parse_json_rows(const char*& p, bool nested, std::vector<std::vector<double>>& rows) {
+    auto skip = [&]() { while (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t') ++p; };
+    auto number_list = [&](std::vector<double>& values) {
+        skip();
+        if (*p != '[') return false;
+        ++p;
+        skip();
+        if (*p == ']') { ++p; return true; }
+        while (true) {
+            char* end;
+            values.push_back(std::strtod(p, &end));
+            if (end == p) return false;
+            p = end;
+            skip();
+            if (*p == ',') { ++p; continue; }
+            if (*p == ']') { ++p; return true; }
+            return false;
+        }
+    };
+
+    rows.clear();
+    if (!nested) {
+        std::vector<double> values;
+        if (!number_list(values)) return false;
+        for (double v : values) rows.push_back({ v });
+        return true;
+    }
+    skip();
+    if (*p != '[') return false;
+    ++p;
+    skip();
+    if (*p == ']') { ++p; return true; }
+    while (true) {
+        rows.emplace_back();
+        if (!number_list(rows.back())) return false;
+        skip();
+        if (*p == ',') { ++p; continue; }
+        if (*p == ']') { ++p; return true; }
+        return false;
+    }
+}
+
+inline const char* find_json_field(const std::string& body, const char* name) {
+    const size_t at = body.find(std::string("\"") + name + "\"");
+    if (at == std::string::npos) return nullptr;
+    const size_t colon = body.find(':', at);
+    return colon == std::string::npos ? nullptr : body.c_str() + colon + 1;
+}
+
+// --- Requests: design vectors ---
+inline std::string encode_designs(const std::vector<const std::vector<double>*>& designs, bool binary) {
+    std::string out;
+    if (binary) {
+        const int32_t width = designs.empty() ? 0 : static_cast<int32_t>(designs[0]->size());
+        out.reserve(2 * sizeof(int32_t) + designs.size() * width * sizeof(double));
+        append_rows(out, static_cast<int32_t>(designs.size()), width);
+        for (const auto* x : designs) {
+            for (double v : *x) append_double(out, v);
+        }
+        return out;
+    }
+    out = "{\"x\":[";
+    for (size_t i = 0; i < designs.size(); ++i) {
+        out += i ? ",[" : "[";
+        for (size_t j = 0; j < designs[i]->size(); ++j) {
+            if (j) out += ',';
+            append_json_number(out, (*designs[i])[j]);
+        }
+        out += ']';
+    }
+    out += "]}";
+    return out;
+}
+
+inline bool decode_designs(const std::string& body, bool binary, std::vector<std::vector<double>>& designs) {
+    if (binary) return read_rows_binary(body, designs);
+    const char* p = find_json_field(body, "x");
+    return p && parse_json_rows(p, true, designs);
+}
+
+// --- Responses: objective + constraint violations per design ---
+inline std::string encode_results(const std::vector<double>& objectives,
+    const std::vector<std::vector<double>>& constraints, bool binary) {
+    std::string out;
+    if (binary) {
+        const int32_t width = 1 + (constraints.empty() ? 0 : static_cast<int32_t>(constraints[0].size()));
+        append_rows(out, static_cast<int32_t>(objectives.size()), width);
+        for (size_t i = 0; i < objectives.size(); ++i) {
+            append_double(out, objectives[i]);
+            for (double v : constraints[i]) append_double(out, v);
+        }
+        return out;
+    }
+    out = "{\"f\":[";
+    for (size_t i = 0; i < objectives.size(); ++i) {
+        if (i) out += ',';
+        append_json_number(out, objectives[i]);
+    }
+    out += "],\"g\":[";
+    for (size_t i = 0; i < constraints.size(); ++i) {
+        out += i ? ",[" : "[";
+        for (size_t j = 0; j < constraints[i].size(); ++j) {
+            if (j) out += ',';
+            append_json_number(out, constraints[i][j]);
+        }
+        out += ']';
+    }
+    out += "]}";
+    return out;
+}
+
+inline bool decode_results(const std::string& body, bool binary,
+    std::vector<double>& objectives, std::vector<std::vector<double>>& constraints) {
+    std::vector<std::vector<double>> rows;
+    if (binary) {
+        if (!read_rows_binary(body, rows)) return false;
+        objectives.clear();
+        constraints.clear();
+        for (auto& row : rows) {
+            if (row.empty()) return false;
+            objectives.push_back(row[0]);
+            constraints.emplace_back(row.begin() + 1, row.end());
+        }
+        return true;
+    }
+    const char* f = find_json_field(body, "f");
+    const char* g = find_json_field(body, "g");
+    if (!f || !g || !parse_json_rows(f, false, rows) || !parse_json_rows(g, true, constraints)) return false;
+    objectives.clear();
+    for (auto& row : rows) objectives.push_back(row[0]);
+    return constraints.size() == objectives.size();
+}
+
+} // namespace http_wire
+
+// Evaluates batches of individuals on an HTTP evaluation service.
+//
+// A batch handed to evaluate() is split into requests of at most batch_size
+// designs. Requests go out round-robin over a pool of keep-alive connections
+// and up to max_in_flight of them are outstanding at once (HTTP/1.1
+// pipelining; responses on a connection arrive in request order). A request
+// that fails (connection error, 5xx, 408, 429) is sent again on a fresh
+// connection after an exponential backoff, together with any requests that
+// were queued behind it on the same connection.
+//
+// evaluate() may be called from several threads at once (e.g. portfolio
+// members sharing one service). Each call checks connections out of the pool
+// for its duration, so calls only contend for the pool and the statistics,
+// never for a socket; a call waits only while every connection is in use.
+class HttpEvaluator {
+public:
+    struct Config {
+        std::string host = "127.0.0.1";
+        int port = 8080;
+        std::string path = "/evaluate";
+        int batch_size = 64;      // designs per request
+        int connections = 4;      // keep-alive connection pool size
+        int max_in_flight = 8;    // outstanding requests per evaluate() call
+        int max_retries = 3;      // per request
+        int backoff_ms = 10;      // first retry delay; doubles each attempt
+        int timeout_ms = 30000;   // send/receive timeout per socket operation
+        bool binary = true;       // octet-stream payloads instead of JSON
+        bool keep_alive = true;   // false: one connection per request
+    };
+
+    struct Stats {
+        long long requests = 0;   // responses received, including failed ones
+        long long designs = 0;    // designs evaluated
+        long long retries = 0;    // requests sent again
+        long long connects = 0;   // connections opened
+        long long bytes_sent = 0;
+        long long bytes_received = 0;
+    };
+
+    explicit HttpEvaluator(Config config) : m_config(std::move(config)) {
+        m_config.batch_size = std::max(1, m_config.batch_size);
+        m_config.connections = std::max(1, m_config.connections);
+        m_config.max_in_flight = std::max(1, m_config.max_in_flight);
+        http_wire::startup();
+        idle.resize(m_config.connections);
+    }
+
+    ~HttpEvaluator() {
+        for (auto& c : idle) disconnect(c);
+    }
+
+    HttpEvaluator(const HttpEvaluator&) = delete;
+    HttpEvaluator& operator=(const HttpEvaluator&) = delete;
+
+    const Config& config() const { return m_config; }
+
+    Stats stats() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats;
+    }
+
+    // Fills objective_value and constraint_violations of every individual.
+    // Throws std::runtime_error once a request has used up its retries.
+    void evaluate(const std::vector<Individual*>& batch) {
+        const int count = static_cast<int>(batch.size());
+        const int num_requests = (count + m_config.batch_size - 1) / m_config.batch_size;
+        if (num_requests == 0) return;
+        Call call(*this, std::min(num_requests, m_config.max_in_flight));
+        std::vector<Connection>& pool = call.connections;
+        Stats& stats = call.stats;
+
+        struct Pending { int request; int connection; };
+        std::deque<int> ready;
+        for (int r = 0; r < num_requests; ++r) ready.push_back(r);
+        std::deque<Pending> in_flight;
+        std::vector<int> attempts(num_requests, 0);
+
+        // Requeues every request outstanding on connection c (plus 'failed')
+        auto fail = [&](int c, int failed, const std::string& reason) {
+            disconnect(pool[c]);
+            std::vector<int> lost;
+            if (failed >= 0) lost.push_back(failed);
+            for (auto it = in_flight.begin(); it != in_flight.end();) {
+                if (it->connection == c) { lost.push_back(it->request); it = in_flight.erase(it); }
+                else ++it;
+            }
+            int worst = 0;
+            for (int r : lost) {
+                if (++attempts[r] > m_config.max_retries) abort(call, "request failed after retries (" + reason + ")");
+                worst = std::max(worst, attempts[r]);
+                stats.retries++;
+            }
+            std::sort(lost.begin(), lost.end());
+            for (auto it = lost.rbegin(); it != lost.rend(); ++it) ready.push_front(*it);
+            if (worst > 0) std::this_thread::sleep_for(std::chrono::milliseconds(m_config.backoff_ms << (worst - 1)));
+        };
+
+        std::vector<const std::vector<double>*> designs;
+        std::vector<double> objectives;
+        std::vector<std::vector<double>> constraints;
+        while (!ready.empty() || !in_flight.empty()) {
+            while (!ready.empty() && (int)in_flight.size() < m_config.max_in_flight) {
+                const int c = pick_connection(call, in_flight);
+                if (c < 0) break;
+                const int r = ready.front();
+                ready.pop_front();
+
+                const int lo = r * m_config.batch_size, hi = std::min(count, lo + m_config.batch_size);
+                designs.clear();
+                for (int i = lo; i < hi; ++i) designs.push_back(&batch[i]->variables);
+                if (!send_request(call, pool[c], http_wire::encode_designs(designs, m_config.binary))) {
+                    fail(c, r, "send");
+                    continue;
+                }
+                in_flight.push_back({ r, c });
+            }
+            if (in_flight.empty()) continue;
+
+            const Pending p = in_flight.front();
+            in_flight.pop_front();
+            Connection& conn = pool[p.connection];
+            http_wire::Message response;
+            if (!http_wire::read_message(conn.socket, conn.buffer, response)) {
+                if (!response.error.empty()) abort(call, response.error);
+                fail(p.connection, p.request, "receive");
+                continue;
+            }
+            stats.requests++;
+            stats.bytes_received += static_cast<long long>(response.body.size());
+
+            const int status = http_wire::status_code(response);
+            if (status >= 500 || status == 408 || status == 429) {
+                fail(p.connection, p.request, response.start_line);
+                continue;
+            }
+            if (status != 200) abort(call, response.start_line);
+
+            const bool binary = response.content_type.find("json") == std::string::npos;
+            const int lo = p.request * m_config.batch_size, hi = std::min(count, lo + m_config.batch_size);
+            if (!http_wire::decode_results(response.body, binary, objectives, constraints) ||
+                (int)objectives.size() != hi - lo) {
+                abort(call, "malformed response body");
+            }
+            for (int i = lo; i < hi; ++i) {
+                batch[i]->objective_value = objectives[i - lo];
+                batch[i]->constraint_violations = std::move(constraints[i - lo]);
+            }
+            stats.designs += hi - lo;
+
+            if (response.close || !m_config.keep_alive) {
+                // Anything pipelined behind this response is lost with the connection
+                if (std::any_of(in_flight.begin(), in_flight.end(), [&](const Pending& q) { return q.connection == p.connection; })) {
+                    fail(p.connection, -1, "connection closed by server");
+                }
+                else {
+                    disconnect(conn);
+                }
+            }
+        }
+    }
+
+private:
+    struct Connection {
+        http_wire::socket_t socket = http_wire::BAD_SOCKET;
+        std::string buffer; // received bytes not yet consumed
+    };
+
+    // Connections and counters of one evaluate() call; the connections go
+    // back to the pool and the counters into the totals when it ends, also
+    // when it throws
+    struct Call {
+        HttpEvaluator& owner;
+        std::vector<Connection> connections;
+        int next_connection = 0;
+        Stats stats;
+
+        Call(HttpEvaluator& e, int wanted) : owner(e) { owner.check_out(connections, wanted); }
+        ~Call() { owner.check_in(connections, stats); }
+    };
+
+    Config m_config;
+    std::vector<Connection> idle; // connections not checked out by a call
+    Stats m_stats;
+    mutable std::mutex m_mutex;   // guards idle and m_stats
+    std::condition_variable m_idle_cv;
+
+    // Takes up to 'wanted' idle connections, waiting until at least one is free
+    void check_out(std::vector<Connection>& out, int wanted) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_idle_cv.wait(lock, [this]() { return !idle.empty(); });
+        while (!idle.empty() && (int)out.size() < wanted) {
+            out.push_back(std::move(idle.back()));
+            idle.pop_back();
+        }
+    }
+
+    void check_in(std::vector<Connection>& connections, const Stats& s) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (auto& c : connections) idle.push_back(std::move(c));
+            m_stats.requests += s.requests;
+            m_stats.designs += s.designs;
+            m_stats.retries += s.retries;
+            m_stats.connects += s.connects;
+            m_stats.bytes_sent += s.bytes_sent;
+            m_stats.bytes_received += s.bytes_received;
+        }
+        connections.clear();
+        m_idle_cv.notify_all();
+    }
+
+    void disconnect(Connection& c) {
+        if (c.socket != http_wire::BAD_SOCKET) http_wire::close_socket(c.socket);
+        c.socket = http_wire::BAD_SOCKET;
+        c.buffer.clear();
+    }
+
+    // Round-robin over the call's connections; without keep-alive only idle ones qualify
+    template <typename PendingList>
+    int pick_connection(Call& call, const PendingList& in_flight) {
+        const int size = static_cast<int>(call.connections.size());
+        for (int k = 0; k < size; ++k) {
+            const int c = (call.next_connection + k) % size;
+            if (!m_config.keep_alive &&
+                std::any_of(in_flight.begin(), in_flight.end(), [c](const auto& q) { return q.connection == c; })) continue;
+            call.next_connection = c + 1;
+            return c;
+        }
+        return -1;
+    }
+
+    // Unread responses would desynchronise the call's connections, so they all go
+    [[noreturn]] void abort(Call& call, const std::string& reason) {
+        for (auto& c : call.connections) disconnect(c);
+        throw std::runtime_error("HttpEvaluator: " + reason);
+    }
+
+    bool connect(Call& call, Connection& c) {
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* found = nullptr;
+        if (getaddrinfo(m_config.host.c_str(), std::to_string(m_config.port).c_str(), &hints, &found) != 0) return false;
+
+        for (addrinfo* a = found; a; a = a->ai_next) {
+            http_wire::socket_t s = ::socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+            if (s == http_wire::BAD_SOCKET) continue;
+            int one = 1;
+            setsockopt(s, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&one), sizeof(one));
+#ifdef _WIN32
+            DWORD timeout = static_cast<DWORD>(m_config.timeout_ms);
+#else
+            timeval timeout{ m_config.timeout_ms / 1000, (m_config.timeout_ms % 1000) * 1000 };
+#endif
+            setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+            setsockopt(s, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+            if (::connect(s, a->ai_addr, static_cast<int>(a->ai_addrlen)) == 0) {
+                c.socket = s;
+                break;
+            }
+            http_wire::close_socket(s);
+        }
+        freeaddrinfo(found);
+        if (c.socket == http_wire::BAD_SOCKET) return false;
+        call.stats.connects++;
+        return true;
+    }
+
+    bool send_request(Call& call, Connection& c, const std::string& body) {
+        if (c.socket == http_wire::BAD_SOCKET && !connect(call, c)) return false;
+        std::string request = "POST " + m_config.path + " HTTP/1.1\r\nHost: " + m_config.host + ":" +
+            std::to_string(m_config.port) + "\r\nContent-Type: " + http_wire::content_type(m_config.binary) +
+            "\r\nContent-Length: " + std::to_string(body.size()) +
+            (m_config.keep_alive ? "\r\n\r\n" : "\r\nConnection: close\r\n\r\n");
+        request += body;
+        if (!http_wire::send_all(c.socket, request.data(), request.size())) return false;
+        call.stats.bytes_sent += static_cast<long long>(body.size());
+        return true;
+    }
+};
@@ -0,0 +1,123 @@
+#pragma once
+#include "TrajectoryLog.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Who pulled whom in one step of a trajectory log with an influence column.
+//
+// Every agent points at the agent it moved toward: followers at a local
+// leader (Step 4), local leaders at a super leader (Step 7). Agents that did
+// not move are roots, so the step forms a forest whose trees are the basins
+// of the super leaders (or of leaders that no one outranked). A root whose
+// basin covers most of the population is the "one super leader drags every
+// society" pattern.
+class InfluenceTree {
+public:
+    struct Root {
+        int32_t agent;
+        int reach;      // agents in its tree, itself included
+        int direct;     // agents that moved toward it
+        bool super_leader;
+    };
+
+    InfluenceTree(const TrajectoryLog& log, int32_t run, int32_t time) {
+        if (!log.has_influence()) throw std::invalid_argument("InfluenceTree: the log has no influence column");
+        for (const TrajectoryLog::Step& s : log.find_step(run, time)) {
+            for (uint64_t i = s.first; i < s.first + s.count; ++i) {
+                const int32_t a = log.agent[i];
+                if (a >= (int32_t)parent.size()) {
+                    parent.resize(a + 1, -1);
+                    present.resize(a + 1, 0);
+                    flags.resize(a + 1, 0);
+                }
+                parent[a] = log.influence[i];
+                present[a] = 1;
+                flags[a] = log.flags[i];
+            }
+        }
+        if (parent.empty()) {
+            throw std::invalid_argument("InfluenceTree: no rows for run " + std::to_string(run) + ", time " + std::to_string(time));
+        }
+
+        // Roots by path following; a malformed log (a cycle, or a target
+        // outside the step) ends the path at the last valid agent
+        const int32_t n = static_cast<int32_t>(parent.size());
+        root.assign(n, -1);
+        children.assign(n, {});
+        for (int32_t a = 0; a < n; ++a) {
+            if (!present[a]) continue;
+            const int32_t p = parent[a];
+            if (p >= 0 && p < n && present[p] && p != a) children[p].push_back(a);
+            int32_t r = a;
+            for (int hops = 0; hops < n; ++hops) {
+                const int32_t up = parent[r];
+                if (up < 0 || up >= n || !present[up] || up == a) break;
+                r = up;
+            }
+            root[a] = r;
+        }
+
+        std::vector<int> reach(n, 0);
+        for (int32_t a = 0; a < n; ++a) {
+            if (present[a]) reach[root[a]]++;
+        }
+        for (int32_t a = 0; a < n; ++a) {
+            if (present[a] && root[a] == a) {
+                m_roots.push_back({ a, reach[a], static_cast<int>(children[a].size()), (flags[a] & TrajectoryLog::SUPER_LEADER) != 0 });
+            }
+            if (present[a]) m_agents++;
+        }
+        std::sort(m_roots.begin(), m_roots.end(), [](const Root& x, const Root& y) {
+            return x.reach != y.reach ? x.reach > y.reach : x.agent < y.agent;
+        });
+    }
+
+    // Roots, largest basin first
+    const std::vector<Root>& roots() const { return m_roots; }
+    int agents() const { return m_agents; }
+
+    // Share of agents in the largest basin
+    double top_share() const { return m_roots.empty() || m_agents == 0 ? 0.0 : static_cast<double>(m_roots.front().reach) / m_agents; }
+
+    int32_t root_of(int32_t agent) const { return root.at(agent); }
+    int32_t influenced_by(int32_t agent) const { return parent.at(agent); }
+    const std::vector<int32_t>& influenced(int32_t agent) const { return children.at(agent); }
+
+    // Indented tree of each of the first 'max_roots' basins
+    void print(std::ostream& out, int max_roots = 5, int max_children = 8) const {
+        for (int k = 0; k < std::min<int>(max_roots, static_cast<int>(m_roots.size())); ++k) {
+            const Root& r = m_roots[k];
+            out << "agent " << r.agent << (r.super_leader ? " (super leader)" : "") << ": reach " << r.reach
+                << ", pulled " << r.direct << " directly\n";
+            print_children(out, r.agent, 1, max_children);
+        }
+        if ((int)m_roots.size() > max_roots) out << "... " << m_roots.size() - max_roots << " more root(s)\n";
+    }
+
+private:
+    std::vector<int32_t> parent, root;
+    std::vector<uint8_t> present, flags;
+    std::vector<std::vector<int32_t>> children;
+    std::vector<Root> m_roots;
+    int m_agents = 0;
+
+    void print_children(std::ostream& out, int32_t agent, int depth, int max_children) const {
+        const std::vector<int32_t>& kids = children[agent];
+        int shown = 0;
+        for (int32_t c : kids) {
+            if (shown++ == max_children) {
+                out << std::string(2 * depth, ' ') << "... " << kids.size() - max_children << " more\n";
+                break;
+            }
+            out << std::string(2 * depth, ' ') << "agent " << c;
+            if (flags[c] & TrajectoryLog::LOCAL_LEADER) out << " (leader, pulled " << children[c].size() << ")";
+            out << "\n";
+            if (depth < 8 && !children[c].empty()) print_children(out, c, depth + 1, max_children);
+        }
+    }
+};
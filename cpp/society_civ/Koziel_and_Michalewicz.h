@@ -2,14 +2,16 @@
 #include <vector>
 #include <cmath>
 #include <functional>
+#include <atomic>
 #include "Individual.h"
 
 // 1. The Concrete Implementation for the "Two-Variable Problem"
 // Reference: Section 4.1 of the paper
 struct TwoVariableDesign {
 
-    // Mutable allows modification even in const methods
-    mutable int evaluations = 0;
+    // Mutable allows modification even in const methods;
+    // atomic so that parallel evaluation can share one problem instance
+    mutable std::atomic<int> evaluations{ 0 };
 
     // Call this at the start of every run
     void reset_evaluations() const {
@@ -39,18 +41,28 @@ struct TwoVariableDesign {
         //// Constraint 2: -(x1 - 6)^2 - (x2 - 5)^2 + 82.81 >= 0
         //double g2 = -std::pow(x1 - 6.0, 2) - std::pow(x2 - 5.0, 2) + 82.81;
 
-        const auto raw = get_constraints_raw_values(ind);
+        get_constraints_violation(ind, violations);
+        return violations;
+    }
+
+    // Same, written into 'violations' (reuses its storage)
+    void get_constraints_violation(const Individual& ind, std::vector<double>& violations) const {
+        get_constraints_raw_values(ind, violations);
 
         // Logic: If g(x) >= 0, violation is 0. Else, violation is |g(x)|
-        for (double g : raw) {
-            violations.push_back((g >= 0.0) ? 0.0 : -g);
+        for (double& g : violations) {
+            g = (g >= 0.0) ? 0.0 : -g;
         }
-
-        return violations;
     }
 
     // NEW: Helper to get raw g(x) values for reporting
     std::vector<double> get_constraints_raw_values(const Individual& ind) const {
+        std::vector<double> raw;
+        get_constraints_raw_values(ind, raw);
+        return raw;
+    }
+
+    void get_constraints_raw_values(const Individual& ind, std::vector<double>& raw) const {
         if (ind.variables.size() < 2) {
             throw std::runtime_error("TwoVariableDesign expects 2 variables");
         }
@@ -64,6 +76,6 @@ struct TwoVariableDesign {
         // Constraint 2: -(x1 - 6)^2 - (x2 - 5)^2 + 82.81 >= 0
         double g2 = -std::pow(x1 - 6.0, 2) - std::pow(x2 - 5.0, 2) + 82.81;
 
-        return { g1, g2 };
+        raw.assign({ g1, g2 });
     }
 };
\ No newline at end of file
@@ -0,0 +1,209 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+// Global budget of concurrent evaluations, e.g. floating license tokens of a
+// commercial solver.
+//
+// Within a process, runs register as clients and each evaluation holds one
+// token (see Lease). A freed token goes to the waiting client that holds the
+// fewest tokens at that moment, the longest-waiting request first on ties, so
+// concurrent runs get an equal share of the budget.
+//
+// With a token directory, each granted token also takes an exclusive lock on
+// one of 'tokens' lock files in that directory. Processes (or pools) sharing
+// the directory therefore never exceed the budget together. The OS drops the
+// locks of a process that dies, so a crashed job cannot leak tokens.
+//
+// acquire() sleeps on a condition variable (or polls the lock files), so a
+// TaskRuntime thread waiting for a token runs no other task meanwhile.
+class LicensePool {
+public:
+    struct ClientStats {
+        std::string label;
+        long long acquisitions = 0;
+        double wait_seconds = 0.0;     // total time spent waiting for tokens
+        double max_wait_seconds = 0.0; // longest single wait
+        int held = 0;                  // tokens held right now
+    };
+
+    // RAII token; a null pool makes it a no-op
+    class Lease {
+    public:
+        Lease(LicensePool* pool, int client) : m_pool(pool), m_client(client) {
+            if (m_pool) m_slot = m_pool->acquire(m_client);
+        }
+        ~Lease() {
+            if (m_pool) m_pool->release(m_client, m_slot);
+        }
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+    private:
+        LicensePool* m_pool;
+        int m_client;
+        int m_slot = -1;
+    };
+
+    explicit LicensePool(int tokens, const std::string& token_dir = "")
+        : m_tokens(tokens), m_token_dir(token_dir) {
+        if (tokens <= 0) throw std::invalid_argument("LicensePool: tokens must be positive");
+        if (!token_dir.empty()) {
+            for (int k = 0; k < tokens; ++k) slots.push_back(std::make_unique<Slot>(token_dir + "/token." + std::to_string(k) + ".lock"));
+        }
+    }
+
+    int tokens() const { return m_tokens; }
+    const std::string& token_dir() const { return m_token_dir; }
+
+    int register_client(const std::string& label) {
+        std::lock_guard<std::mutex> lock(mutex);
+        clients.push_back(ClientStats());
+        clients.back().label = label;
+        return static_cast<int>(clients.size()) - 1;
+    }
+
+    ClientStats client_stats(int client) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return clients.at(client);
+    }
+
+    // Most tokens this pool had granted at the same time
+    int peak_in_use() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return m_peak;
+    }
+
+    // Blocks until a token is granted; returns the lock-file slot (-1 without a directory)
+    int acquire(int client) {
+        const auto start = std::chrono::steady_clock::now();
+        int slot = -1;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            const long long ticket = next_ticket++;
+            waiting.push_back({ client, ticket });
+            granted.wait(lock, [&]() { return in_use < m_tokens && next_grant() == ticket; });
+            waiting.erase(std::find_if(waiting.begin(), waiting.end(), [ticket](const Request& r) { return r.ticket == ticket; }));
+            in_use++;
+            m_peak = std::max(m_peak, in_use);
+            clients[client].held++;
+        }
+        granted.notify_all(); // the next request may be grantable too
+
+        // Every lock file may be held by other processes; poll with backoff
+        if (!slots.empty()) {
+            int delay_us = 100;
+            while (true) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    for (int k = 0; k < m_tokens && slot < 0; ++k) {
+                        if (!slots[k]->busy && slots[k]->try_lock()) {
+                            slots[k]->busy = true;
+                            slot = k;
+                        }
+                    }
+                }
+                if (slot >= 0) break;
+                std::this_thread::sleep_for(std::chrono::microseconds(delay_us));
+                delay_us = std::min(delay_us * 2, 20000);
+            }
+        }
+
+        const double waited = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::lock_guard<std::mutex> lock(mutex);
+        ClientStats& stats = clients[client];
+        stats.acquisitions++;
+        stats.wait_seconds += waited;
+        stats.max_wait_seconds = std::max(stats.max_wait_seconds, waited);
+        return slot;
+    }
+
+    void release(int client, int slot) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (slot >= 0) {
+                slots[slot]->unlock();
+                slots[slot]->busy = false;
+            }
+            in_use--;
+            clients[client].held--;
+        }
+        granted.notify_all();
+    }
+
+private:
+    struct Request {
+        int client;
+        long long ticket;
+    };
+
+    // One lock file of the token directory
+    struct Slot {
+        bool busy = false; // locked by this pool (guarded by the pool mutex)
+#ifdef _WIN32
+        HANDLE file;
+        explicit Slot(const std::string& path) {
+            file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE) throw std::runtime_error("LicensePool: cannot open '" + path + "'");
+        }
+        ~Slot() { CloseHandle(file); }
+        bool try_lock() {
+            OVERLAPPED at{};
+            return LockFileEx(file, LOCKFILE_EXCLUSIVE_LOCK | LOCKFILE_FAIL_IMMEDIATELY, 0, 1, 0, &at) != 0;
+        }
+        void unlock() {
+            OVERLAPPED at{};
+            UnlockFileEx(file, 0, 1, 0, &at);
+        }
+#else
+        int fd;
+        explicit Slot(const std::string& path) {
+            fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0666);
+            if (fd < 0) throw std::runtime_error("LicensePool: cannot open '" + path + "'");
+        }
+        ~Slot() { ::close(fd); }
+        bool try_lock() { return flock(fd, LOCK_EX | LOCK_NB) == 0; }
+        void unlock() { flock(fd, LOCK_UN); }
+#endif
+    };
+
+    int m_tokens;
+    std::string m_token_dir;
+    std::vector<std::unique_ptr<Slot>> slots;
+
+    mutable std::mutex mutex;
+    std::condition_variable granted;
+    std::vector<ClientStats> clients;
+    std::vector<Request> waiting; // in arrival order
+    long long next_ticket = 0;
+    int in_use = 0;
+    int m_peak = 0;
+
+    // Ticket of the request served next: fewest tokens held, then oldest
+    long long next_grant() const {
+        const Request* best = nullptr;
+        for (const Request& r : waiting) {
+            if (!best || clients[r.client].held < clients[best->client].held) best = &r;
+        }
+        return best ? best->ticket : -1;
+    }
+};
@@ -0,0 +1,73 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Cheap constraints a.x <= b that a problem can declare next to its expensive
+// ones: bound-type and geometric conditions such as h <= b in the welded
+// beam, which need no simulation. Candidates are checked and repaired against
+// them before they reach the evaluator (see Civilization::set_repair).
+class LinearConstraints {
+public:
+    void add(std::vector<double> a, double b) {
+        double norm2 = 0.0;
+        for (double v : a) norm2 += v * v;
+        if (norm2 == 0.0) throw std::invalid_argument("LinearConstraints: all-zero coefficients");
+        if (!rows.empty() && a.size() != rows.front().a.size()) {
+            throw std::invalid_argument("LinearConstraints: coefficient count differs from the first constraint");
+        }
+        // Projections land this far inside, so that the expensive evaluation
+        // of the same constraint does not see rounding noise as a violation
+        const double margin = 1e-9 * std::max(1.0, std::abs(b));
+        rows.push_back({ std::move(a), b, norm2, margin });
+    }
+
+    bool empty() const { return rows.empty(); }
+    size_t size() const { return rows.size(); }
+    int dimension() const { return rows.empty() ? 0 : static_cast<int>(rows.front().a.size()); }
+
+    bool satisfied(const double* x) const {
+        for (const Row& r : rows) {
+            if (dot(r, x) > r.b) return false;
+        }
+        return true;
+    }
+
+    // Moves x into the constraints and the box [lb, ub] by cyclic projection
+    // onto each violated half-space, clamping to the box after every sweep.
+    // Returns false if x still violates a constraint after 'max_sweeps'
+    // (e.g. the constraints and the box do not intersect).
+    bool project(double* x, const std::vector<double>& lb, const std::vector<double>& ub, int max_sweeps = 50) const {
+        const size_t n = lb.size();
+        for (int sweep = 0; sweep < max_sweeps; ++sweep) {
+            bool moved = false;
+            for (const Row& r : rows) {
+                const double excess = dot(r, x) - r.b;
+                if (excess <= 0.0) continue;
+                const double step = (excess + r.margin) / r.norm2;
+                for (size_t j = 0; j < n; ++j) x[j] -= step * r.a[j];
+                moved = true;
+            }
+            for (size_t j = 0; j < n; ++j) x[j] = std::min(std::max(x[j], lb[j]), ub[j]);
+            if (!moved || satisfied(x)) return satisfied(x);
+        }
+        return satisfied(x);
+    }
+
+private:
+    struct Row {
+        std::vector<double> a;
+        double b;
+        double norm2;
+        double margin;
+    };
+    std::vector<Row> rows;
+
+    static double dot(const Row& r, const double* x) {
+        double s = 0.0;
+        for (size_t j = 0; j < r.a.size(); ++j) s += r.a[j] * x[j];
+        return s;
+    }
+};
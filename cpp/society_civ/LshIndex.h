@@ -0,0 +1,118 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+// Approximate nearest-neighbour index for Euclidean distance (p-stable LSH).
+//
+// Each of L tables hashes a point with K projections h(x) = floor((a.x + b) / w),
+// a ~ N(0, I), b ~ U[0, w). A query checks the exact distance of every point
+// sharing a bucket with it in any table and returns the closest one, or -1
+// when no bucket matches (callers then fall back to exact search).
+//
+// The projection bank is drawn once for max_tables tables; build() may use any
+// prefix of it, which lets callers trade recall for speed step by step.
+class LshIndex {
+public:
+    LshIndex() = default;
+
+    LshIndex(int dims, int max_tables, int hashes_per_table, unsigned seed)
+        : m_dims(dims), m_max_tables(std::max(1, max_tables)), m_hashes(std::max(1, hashes_per_table)) {
+        std::mt19937 gen(seed);
+        std::normal_distribution<double> gauss(0.0, 1.0);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+        const size_t rows = static_cast<size_t>(m_max_tables) * m_hashes;
+        projections.resize(rows * m_dims);
+        offsets.resize(rows);
+        for (double& a : projections) a = gauss(gen);
+        for (double& b : offsets) b = unit(gen);
+    }
+
+    int max_tables() const { return m_max_tables; }
+    int hashes_per_table() const { return m_hashes; }
+    int tables() const { return m_tables; }
+    int size() const { return static_cast<int>(points.size()); }
+
+    // Indexes 'pts' (each of length dims) using the first 'tables' tables
+    void build(const std::vector<const double*>& pts, double width, int tables) {
+        points = pts;
+        m_width = width > 0.0 ? width : 1.0;
+        m_tables = std::min(std::max(tables, 1), m_max_tables);
+        seen.assign(points.size(), 0);
+        m_generation = 0;
+
+        buckets.assign(m_tables, {});
+        for (int t = 0; t < m_tables; ++t) {
+            auto& table = buckets[t];
+            table.reserve(points.size());
+            for (int p = 0; p < (int)points.size(); ++p) table[key(t, points[p])].push_back(p);
+        }
+    }
+
+    // Index (into the built points) of the approximate nearest neighbour, or -1
+    int query(const double* x, long long* distance_evals = nullptr) const {
+        int best = -1;
+        double best_d = std::numeric_limits<double>::max();
+        // A point is seen in this query when its stamp equals the query's
+        // generation, so nothing of size |points| is cleared per query
+        if (++m_generation == 0) {
+            std::fill(seen.begin(), seen.end(), 0u);
+            m_generation = 1;
+        }
+
+        for (int t = 0; t < m_tables; ++t) {
+            auto it = buckets[t].find(key(t, x));
+            if (it == buckets[t].end()) continue;
+            for (int p : it->second) {
+                if (seen[p] == m_generation) continue;
+                seen[p] = m_generation;
+                const double d = squared_distance(x, points[p]);
+                if (distance_evals) ++*distance_evals;
+                if (d < best_d) { best_d = d; best = p; }
+            }
+        }
+        return best;
+    }
+
+private:
+    int m_dims = 0;
+    int m_max_tables = 1;
+    int m_hashes = 1;
+    int m_tables = 0;
+    double m_width = 1.0;
+
+    std::vector<double> projections; // [table][hash][dim]
+    std::vector<double> offsets;     // [table][hash], in units of the width
+    std::vector<const double*> points;
+    std::vector<std::unordered_map<uint64_t, std::vector<int>>> buckets;
+    mutable std::vector<uint32_t> seen; // per point: generation of the last query that checked it
+    mutable uint32_t m_generation = 0;
+
+    double squared_distance(const double* a, const double* b) const {
+        double s = 0.0;
+        for (int j = 0; j < m_dims; ++j) {
+            const double d = a[j] - b[j];
+            s += d * d;
+        }
+        return s;
+    }
+
+    uint64_t key(int table, const double* x) const {
+        uint64_t h = 1469598103934665603ull; // FNV-1a over the K bucket numbers
+        for (int k = 0; k < m_hashes; ++k) {
+            const size_t row = static_cast<size_t>(table) * m_hashes + k;
+            const double* a = &projections[row * m_dims];
+            double dot = 0.0;
+            for (int j = 0; j < m_dims; ++j) dot += a[j] * x[j];
+            const int64_t bucket = static_cast<int64_t>(std::floor(dot / m_width + offsets[row]));
+            h ^= static_cast<uint64_t>(bucket);
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+};
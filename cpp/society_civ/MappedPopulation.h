@@ -0,0 +1,447 @@
+#pragma once
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <sys/ioctl.h>
+#ifndef FICLONE
+#define FICLONE _IOW(0x94, 9, int)
+#endif
+#endif
+
+// Population columns in a memory-mapped file.
+//
+// The file is a column store: a header page, one page-aligned column each
+// for the design variables, objectives, ranks and societies, a small text
+// area for the RNG state, and the constraint violations last (their count is
+// only known after the first evaluation, and the last column can grow
+// without moving the others). Every column has one spare row (slot
+// 'capacity') for the best individual ever seen. Rows are in population
+// index order, the order of the engine's full passes, so a pass streams
+// through the file; advise() tells the OS which rows come next and which
+// ones it may drop from this process (the file keeps them).
+//
+// open() checks the header against the file size before mapping anything,
+// so a truncated or foreign file is rejected instead of read past its end.
+// snapshot() copies the file to a checkpoint through a temporary file,
+// fsync and rename, so a crash leaves either the old or the new checkpoint.
+class MappedPopulation {
+public:
+    static constexpr size_t PAGE = 4096;
+    static constexpr size_t RNG_BYTES = 8192;
+    static constexpr int32_t MAX_WIDTH = 1 << 20; // variables or constraints per row open() accepts
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        int32_t num_variables;
+        int32_t num_constraints;
+        int32_t capacity;
+        int32_t size;
+        int32_t time_step;
+        int64_t evaluations;
+        double epsilon;
+        double epsilon0;
+        int32_t has_best_ever;
+        int32_t rng_length;
+        uint64_t offsets[6]; // variables, objectives, ranks, societies, rng, violations
+    };
+
+    MappedPopulation() = default;
+    ~MappedPopulation() { close(); }
+
+    MappedPopulation(const MappedPopulation&) = delete;
+    MappedPopulation& operator=(const MappedPopulation&) = delete;
+
+    // Creates (or truncates) 'path' with room for 'capacity' individuals
+    void create(const std::string& path, int capacity, int num_variables, int num_constraints) {
+        close();
+        Header h{};
+        std::memcpy(h.magic, MAGIC, sizeof(h.magic));
+        h.version = VERSION;
+        h.num_variables = num_variables;
+        h.num_constraints = num_constraints;
+        h.capacity = capacity;
+        const uint64_t bytes = layout(h);
+        check(h, bytes, path);
+
+        map(path, static_cast<size_t>(bytes), true, true);
+        std::memcpy(m_base, &h, sizeof(h));
+        bind();
+    }
+
+    // Maps an existing file written by create(), after checking its header
+    // against the file size
+    void open(const std::string& path, bool writable = true) {
+        close();
+        Header h{};
+        const uint64_t file_bytes = read_header(path, h);
+        check(h, file_bytes, path);
+        map(path, static_cast<size_t>(layout(h)), false, writable);
+        bind();
+    }
+
+    void close() {
+        if (!m_base) return;
+        unmap();
+        release();
+    }
+
+    bool is_open() const { return m_base != nullptr; }
+    const std::string& path() const { return m_path; }
+    size_t bytes() const { return m_bytes; }
+
+    Header& header() { return *reinterpret_cast<Header*>(m_base); }
+    const Header& header() const { return *reinterpret_cast<const Header*>(m_base); }
+
+    // Row accessors; row 'capacity' is the best-ever slot
+    double* variables(int row) { return m_variables + static_cast<size_t>(row) * m_n; }
+    const double* variables(int row) const { return m_variables + static_cast<size_t>(row) * m_n; }
+    double& objective(int row) { return m_objectives[row]; }
+    double objective(int row) const { return m_objectives[row]; }
+    double* violations(int row) { return m_violations + static_cast<size_t>(row) * m_c; }
+    const double* violations(int row) const { return m_violations + static_cast<size_t>(row) * m_c; }
+    int32_t& rank(int row) { return m_ranks[row]; }
+    int32_t rank(int row) const { return m_ranks[row]; }
+    int32_t& society(int row) { return m_societies[row]; }
+    int32_t society(int row) const { return m_societies[row]; }
+
+    // Resizes the violations column to 'num_constraints' per row (contents
+    // are not kept) and remaps the file: earlier row pointers are invalid
+    void set_constraints(int num_constraints) {
+        if (!m_writable) throw std::logic_error("MappedPopulation::set_constraints(): file is read-only");
+        Header h = header();
+        if (h.num_constraints == num_constraints) return;
+        h.num_constraints = num_constraints;
+        const uint64_t bytes = layout(h);
+        check(h, bytes, m_path);
+        unmap();
+        try {
+#ifndef _WIN32
+            if (ftruncate(m_fd, static_cast<off_t>(bytes)) != 0) {
+                throw std::runtime_error("MappedPopulation: cannot resize '" + m_path + "'");
+            }
+#endif
+            map_view(static_cast<size_t>(bytes), true);
+        }
+        catch (...) {
+            release();
+            throw;
+        }
+        header() = h;
+        bind();
+    }
+
+    void set_rng_state(const std::string& text) {
+        if (text.size() > RNG_BYTES) throw std::runtime_error("MappedPopulation: RNG state too large");
+        std::memcpy(m_base + header().offsets[RNG], text.data(), text.size());
+        header().rng_length = static_cast<int32_t>(text.size());
+    }
+    std::string rng_state() const {
+        return std::string(m_base + header().offsets[RNG], header().rng_length);
+    }
+
+    // Access-pattern hints for rows [first, first + count) of every column.
+    // 'upcoming' has the OS read the rows ahead; otherwise the rows are done
+    // with and their pages are dropped from this process (the file keeps
+    // them). MADV_SEQUENTIAL is not used: it keeps the pages of a pass mapped.
+    void advise(int first, int count, bool upcoming) {
+#ifndef _WIN32
+        if (count <= 0) return;
+        const Header& h = header();
+        const size_t widths[] = { m_n * sizeof(double), sizeof(double), sizeof(int32_t), sizeof(int32_t), 0,
+            m_c * sizeof(double) };
+        for (int c = VARIABLES; c <= VIOLATIONS; ++c) {
+            if (widths[c] == 0) continue;
+            size_t lo = h.offsets[c] + first * widths[c];
+            size_t hi = lo + count * widths[c];
+            lo = lo / PAGE * PAGE;
+            if (!upcoming) hi = hi / PAGE * PAGE; // keep the page shared with the next range
+            if (hi <= lo) continue;
+            madvise(m_base + lo, hi - lo, upcoming ? MADV_WILLNEED : MADV_DONTNEED);
+        }
+#else
+        (void)first; (void)count; (void)upcoming;
+#endif
+    }
+
+    // Starts write-back of dirty pages; 'wait' blocks until they (and the
+    // file size) are on disk
+    void flush(bool wait) {
+        if (!m_base) return;
+#ifdef _WIN32
+        FlushViewOfFile(m_base, 0);
+        if (wait) FlushFileBuffers(m_file);
+#else
+        msync(m_base, m_bytes, wait ? MS_SYNC : MS_ASYNC);
+        if (wait) fsync(m_fd);
+#endif
+    }
+
+    // Copies the file to 'path' crash-safely: into path + ".tmp" (a reflink
+    // where the file system supports it), fsync, then rename over 'path'.
+    // The page cache is shared with the mapping, so the copy sees every write.
+    void snapshot(const std::string& path) const {
+        if (!m_base) throw std::logic_error("MappedPopulation::snapshot(): no file open");
+        if (path == m_path) throw std::invalid_argument("MappedPopulation::snapshot(): '" + path + "' is the mapped file");
+        const std::string tmp = path + ".tmp";
+        copy_file(m_path, tmp, true);
+        replace_file(tmp, path);
+    }
+
+    // Copies 'from' to 'to'; 'durable' also syncs the copy to disk
+    static void copy_file(const std::string& from, const std::string& to, bool durable = false) {
+#ifdef _WIN32
+        if (!CopyFileA(from.c_str(), to.c_str(), FALSE)) {
+            throw std::runtime_error("MappedPopulation: cannot copy '" + from + "' to '" + to + "'");
+        }
+        if (durable) {
+            HANDLE f = CreateFileA(to.c_str(), GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            const bool ok = f != INVALID_HANDLE_VALUE && FlushFileBuffers(f);
+            if (f != INVALID_HANDLE_VALUE) CloseHandle(f);
+            if (!ok) throw std::runtime_error("MappedPopulation: cannot sync '" + to + "'");
+        }
+#else
+        const int in = ::open(from.c_str(), O_RDONLY);
+        if (in < 0) throw std::runtime_error("MappedPopulation: cannot open '" + from + "'");
+        const int out = ::open(to.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (out < 0) {
+            ::close(in);
+            throw std::runtime_error("MappedPopulation: cannot create '" + to + "'");
+        }
+        bool ok = false;
+#ifdef __linux__
+        ok = ioctl(out, FICLONE, in) == 0; // shares the blocks copy-on-write (btrfs, XFS)
+#endif
+        if (!ok) {
+            ok = true;
+            std::vector<char> buffer(1 << 20);
+            for (ssize_t got; ok && (got = ::read(in, buffer.data(), buffer.size())) != 0;) {
+                if (got < 0) {
+                    ok = errno == EINTR;
+                    continue;
+                }
+                for (ssize_t done = 0; ok && done < got;) {
+                    const ssize_t put = ::write(out, buffer.data() + done, static_cast<size_t>(got - done));
+                    if (put > 0) done += put;
+                    else ok = put < 0 && errno == EINTR;
+                }
+            }
+        }
+        if (ok && durable) ok = fsync(out) == 0;
+        ::close(in);
+        if (::close(out) != 0) ok = false;
+        if (!ok) {
+            ::unlink(to.c_str());
+            throw std::runtime_error("MappedPopulation: cannot copy '" + from + "' to '" + to + "'");
+        }
+#endif
+    }
+
+    // Renames 'from' over 'to' and makes the rename itself durable
+    static void replace_file(const std::string& from, const std::string& to) {
+#ifdef _WIN32
+        if (!MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+            throw std::runtime_error("MappedPopulation: cannot replace '" + to + "'");
+        }
+#else
+        if (std::rename(from.c_str(), to.c_str()) != 0) {
+            ::unlink(from.c_str());
+            throw std::runtime_error("MappedPopulation: cannot replace '" + to + "'");
+        }
+        const size_t slash = to.find_last_of('/');
+        const std::string dir = slash == std::string::npos ? "." : (slash == 0 ? "/" : to.substr(0, slash));
+        const int fd = ::open(dir.c_str(), O_RDONLY);
+        if (fd >= 0) {
+            fsync(fd);
+            ::close(fd);
+        }
+#endif
+    }
+
+private:
+    enum Column { VARIABLES = 0, OBJECTIVES, RANKS, SOCIETIES, RNG, VIOLATIONS, COLUMNS };
+    static constexpr char MAGIC[8] = { 'C', 'I', 'V', 'P', 'O', 'P', '0', '2' };
+    static constexpr uint32_t VERSION = 2;
+
+    char* m_base = nullptr;
+    size_t m_bytes = 0;
+    bool m_writable = false;
+    std::string m_path;
+#ifdef _WIN32
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+    HANDLE m_mapping = nullptr;
+#else
+    int m_fd = -1;
+#endif
+
+    // Column pointers and widths, cached by bind()
+    size_t m_n = 0, m_c = 0;
+    double* m_variables = nullptr;
+    double* m_objectives = nullptr;
+    double* m_violations = nullptr;
+    int32_t* m_ranks = nullptr;
+    int32_t* m_societies = nullptr;
+
+    // Fills in the column offsets of 'h' and returns the file size they need
+    static uint64_t layout(Header& h) {
+        const uint64_t rows = static_cast<uint64_t>(h.capacity) + 1;
+        const uint64_t widths[COLUMNS] = {
+            rows * static_cast<uint64_t>(h.num_variables) * sizeof(double), rows * sizeof(double),
+            rows * sizeof(int32_t), rows * sizeof(int32_t), RNG_BYTES,
+            rows * static_cast<uint64_t>(h.num_constraints) * sizeof(double) };
+        uint64_t offset = PAGE; // header page
+        for (int c = 0; c < COLUMNS; ++c) {
+            h.offsets[c] = offset;
+            offset += (widths[c] + PAGE - 1) / PAGE * PAGE;
+        }
+        return offset;
+    }
+
+    // Throws unless 'h' is a header this class wrote for a file of 'file_bytes'
+    static void check(const Header& h, uint64_t file_bytes, const std::string& path) {
+        if (std::memcmp(h.magic, MAGIC, sizeof(h.magic)) != 0 || h.version != VERSION) {
+            throw std::runtime_error("MappedPopulation: '" + path + "' is not a population file");
+        }
+        if (h.num_variables <= 0 || h.num_variables > MAX_WIDTH || h.num_constraints < 0 ||
+            h.num_constraints > MAX_WIDTH || h.capacity <= 0 || h.size < 0 || h.size > h.capacity ||
+            h.time_step < 0 || h.evaluations < 0 || (h.has_best_ever != 0 && h.has_best_ever != 1) ||
+            h.rng_length < 0 || static_cast<size_t>(h.rng_length) > RNG_BYTES) {
+            throw std::runtime_error("MappedPopulation: '" + path + "' has a corrupt header");
+        }
+        Header expected = h;
+        const uint64_t bytes = layout(expected);
+        if (std::memcmp(expected.offsets, h.offsets, sizeof(h.offsets)) != 0) {
+            throw std::runtime_error("MappedPopulation: '" + path + "' has corrupt column offsets");
+        }
+        if (bytes > file_bytes || bytes > static_cast<uint64_t>(SIZE_MAX)) {
+            throw std::runtime_error("MappedPopulation: '" + path + "' is truncated");
+        }
+    }
+
+    // Reads the header of 'path' without mapping it; returns the file size
+    static uint64_t read_header(const std::string& path, Header& h) {
+        uint64_t file_bytes = 0;
+        bool ok = false;
+#ifdef _WIN32
+        HANDLE f = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (f == INVALID_HANDLE_VALUE) throw std::runtime_error("MappedPopulation: cannot open '" + path + "'");
+        LARGE_INTEGER size;
+        DWORD got = 0;
+        if (GetFileSizeEx(f, &size)) {
+            file_bytes = static_cast<uint64_t>(size.QuadPart);
+            ok = file_bytes >= PAGE && ReadFile(f, &h, sizeof(h), &got, nullptr) && got == sizeof(h);
+        }
+        CloseHandle(f);
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("MappedPopulation: cannot open '" + path + "'");
+        struct stat st;
+        if (fstat(fd, &st) == 0) {
+            file_bytes = static_cast<uint64_t>(st.st_size);
+            ok = file_bytes >= PAGE && pread(fd, &h, sizeof(h), 0) == static_cast<ssize_t>(sizeof(h));
+        }
+        ::close(fd);
+#endif
+        if (!ok) throw std::runtime_error("MappedPopulation: '" + path + "' is truncated");
+        return file_bytes;
+    }
+
+    void bind() {
+        const Header& h = header();
+        m_n = static_cast<size_t>(h.num_variables);
+        m_c = static_cast<size_t>(h.num_constraints);
+        m_variables = reinterpret_cast<double*>(m_base + h.offsets[VARIABLES]);
+        m_objectives = reinterpret_cast<double*>(m_base + h.offsets[OBJECTIVES]);
+        m_ranks = reinterpret_cast<int32_t*>(m_base + h.offsets[RANKS]);
+        m_societies = reinterpret_cast<int32_t*>(m_base + h.offsets[SOCIETIES]);
+        m_violations = reinterpret_cast<double*>(m_base + h.offsets[VIOLATIONS]);
+    }
+
+    void map(const std::string& path, size_t bytes, bool create, bool writable) {
+        m_writable = writable;
+#ifdef _WIN32
+        m_file = CreateFileA(path.c_str(), writable ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ, FILE_SHARE_READ,
+            nullptr, create ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (m_file == INVALID_HANDLE_VALUE) throw std::runtime_error("MappedPopulation: cannot open '" + path + "'");
+#else
+        m_fd = ::open(path.c_str(), create ? (O_RDWR | O_CREAT | O_TRUNC) : (writable ? O_RDWR : O_RDONLY), 0644);
+        if (m_fd < 0) throw std::runtime_error("MappedPopulation: cannot open '" + path + "'");
+        if (create && ftruncate(m_fd, static_cast<off_t>(bytes)) != 0) {
+            ::close(m_fd);
+            m_fd = -1;
+            throw std::runtime_error("MappedPopulation: cannot size '" + path + "'");
+        }
+#endif
+        m_path = path;
+        try {
+            map_view(bytes, writable);
+        }
+        catch (...) {
+            release();
+            throw;
+        }
+    }
+
+    // Maps the first 'bytes' of the open file (a writable mapping on Windows
+    // extends the file to 'bytes')
+    void map_view(size_t bytes, bool writable) {
+#ifdef _WIN32
+        m_mapping = CreateFileMappingA(m_file, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY,
+            static_cast<DWORD>(static_cast<uint64_t>(bytes) >> 32), static_cast<DWORD>(bytes & 0xffffffffu), nullptr);
+        void* base = m_mapping ? MapViewOfFile(m_mapping, writable ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ, 0, 0, bytes) : nullptr;
+        if (!base) {
+            if (m_mapping) CloseHandle(m_mapping);
+            m_mapping = nullptr;
+            throw std::runtime_error("MappedPopulation: cannot map '" + m_path + "'");
+        }
+#else
+        void* base = mmap(nullptr, bytes, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, m_fd, 0);
+        if (base == MAP_FAILED) throw std::runtime_error("MappedPopulation: cannot map '" + m_path + "'");
+#endif
+        m_base = static_cast<char*>(base);
+        m_bytes = bytes;
+    }
+
+    void unmap() {
+#ifdef _WIN32
+        UnmapViewOfFile(m_base);
+        CloseHandle(m_mapping);
+        m_mapping = nullptr;
+#else
+        munmap(m_base, m_bytes);
+#endif
+        m_base = nullptr;
+        m_bytes = 0;
+    }
+
+    // Closes the file once it is unmapped
+    void release() {
+#ifdef _WIN32
+        CloseHandle(m_file);
+        m_file = INVALID_HANDLE_VALUE;
+#else
+        ::close(m_fd);
+        m_fd = -1;
+#endif
+        m_path.clear();
+    }
+};
@@ -0,0 +1,207 @@
+#pragma once
+#include "Civilization.h"
+#include "TaskRuntime.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Algorithm portfolio: several differently configured civilizations solve the
+// same problem side by side on the shared TaskRuntime.
+//
+// Time is divided into epochs. In each epoch every member runs a number of
+// time steps proportional to its share of the evaluation budget; members run
+// concurrently, so a member with a larger share also keeps the runtime's
+// workers busy for longer (free workers steal its parallel evaluations).
+// After each epoch the members are ranked by their best solution so far and
+// the laggards hand part of their share to the leader. Optionally the leader's
+// elite is injected into every other member.
+class Portfolio {
+public:
+    struct Config {
+        std::string label;
+        int pop_size = 100;
+        std::function<void(Civilization&)> configure; // optional extra settings
+    };
+
+    struct MemberReport {
+        std::string label;
+        double final_share = 0.0;
+        int steps = 0;
+        long long evaluations = 0;
+        Individual best = Individual(0);
+    };
+
+    struct Result {
+        Individual best = Individual(0);
+        int best_member = -1;
+        long long evaluations = 0;
+        long long evals_to_target = -1; // at epoch granularity; -1 if not reached
+        long long evals_to_feasible = -1; // first strictly feasible member best, at epoch granularity; -1 if none
+        int epochs = 0;
+        std::vector<MemberReport> members;
+    };
+
+    Portfolio(int num_vars,
+        const std::vector<double>& lb,
+        const std::vector<double>& ub,
+        Civilization::ObjFunc obj_func,
+        Civilization::ConFunc con_func,
+        std::vector<Config> configs,
+        unsigned int seed = 10)
+        : n_variables(num_vars), lower_bounds(lb), upper_bounds(ub),
+        m_objective_fn(obj_func), m_constraint_fn(con_func), m_configs(std::move(configs)), m_seed(seed) {
+        if (m_configs.empty()) throw std::invalid_argument("Portfolio: no configurations");
+    }
+
+    // Time steps each member runs per epoch while all shares are equal
+    void set_epoch_steps(int steps) { m_epoch_steps = std::max(1, steps); }
+
+    // Fraction of a laggard's share moved to the leader after each epoch
+    void set_transfer_rate(double rate) { m_transfer_rate = std::min(std::max(rate, 0.0), 1.0); }
+
+    // No member's share drops below this (keeps every configuration alive)
+    void set_min_share(double share) { m_min_share = std::max(share, 0.0); }
+
+    void set_share_elites(bool enabled) { m_share_elites = enabled; }
+
+    // Stop as soon as a feasible objective <= target is found
+    void set_target(double target) {
+        m_has_target = true;
+        m_target = target;
+    }
+
+    Result run(long long evaluation_budget) {
+        const int k = static_cast<int>(m_configs.size());
+        const double min_share = std::min(m_min_share, 1.0 / k);
+
+        std::vector<std::unique_ptr<Civilization>> members;
+        for (int i = 0; i < k; ++i) {
+            members.push_back(std::make_unique<Civilization>(
+                m_configs[i].pop_size, n_variables, lower_bounds, upper_bounds,
+                m_objective_fn, m_constraint_fn, m_seed + 7919u * static_cast<unsigned>(i)));
+            members[i]->set_verbose(false);
+            if (m_configs[i].configure) m_configs[i].configure(*members[i]);
+            members[i]->initialize();
+        }
+
+        std::vector<double> shares(k, 1.0 / k);
+        std::vector<int> steps_run(k, 0);
+        Result result;
+
+        auto used = [&]() {
+            long long total = 0;
+            for (const auto& civ : members) total += civ->evaluations();
+            return total;
+        };
+
+        while (true) {
+            const long long remaining = evaluation_budget - used();
+
+            // Steps per member this epoch, trimmed to the remaining budget
+            std::vector<int> steps(k, 0);
+            long long planned = 0;
+            for (int i = 0; i < k; ++i) {
+                steps[i] = std::max(1, static_cast<int>(std::lround(shares[i] * k * m_epoch_steps)));
+                planned += static_cast<long long>(steps[i]) * m_configs[i].pop_size;
+            }
+            if (planned > remaining) {
+                const double scale = static_cast<double>(remaining) / planned;
+                planned = 0;
+                for (int i = 0; i < k; ++i) {
+                    steps[i] = static_cast<int>(std::floor(steps[i] * scale));
+                    planned += static_cast<long long>(steps[i]) * m_configs[i].pop_size;
+                }
+            }
+            if (planned == 0) break;
+
+            TaskRuntime::instance().parallel_for(0, k, [&](int i) {
+                for (int s = 0; s < steps[i]; ++s) members[i]->step();
+            });
+            for (int i = 0; i < k; ++i) steps_run[i] += steps[i];
+            result.epochs++;
+
+            // Rank members by their best solution so far
+            std::vector<int> order(k);
+            std::iota(order.begin(), order.end(), 0);
+            std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+                return better_member(*members[a], *members[b]);
+            });
+            const int leader = order.front();
+
+            if (result.evals_to_feasible < 0 && members[leader]->has_best_ever() &&
+                Civilization::is_feasible(members[leader]->get_best_ever())) {
+                result.evals_to_feasible = used();
+            }
+
+            if (m_has_target && result.evals_to_target < 0 && members[leader]->has_best_ever()) {
+                const Individual& best = members[leader]->get_best_ever();
+                if (Civilization::is_feasible(best) && best.objective_value <= m_target) {
+                    result.evals_to_target = used();
+                    break;
+                }
+            }
+
+            // Laggards (bottom half) hand part of their share to the leader
+            for (int pos = (k + 1) / 2; pos < k; ++pos) {
+                const int i = order[pos];
+                const double give = std::min(shares[i] * m_transfer_rate, shares[i] - min_share);
+                if (give <= 0.0) continue;
+                shares[i] -= give;
+                shares[leader] += give;
+            }
+
+            if (m_share_elites && members[leader]->has_best_ever()) {
+                const Individual elite = members[leader]->get_best_ever();
+                for (int i = 0; i < k; ++i) {
+                    if (i != leader) members[i]->inject_individual(elite);
+                }
+            }
+        }
+
+        result.evaluations = used();
+        for (int i = 0; i < k; ++i) {
+            MemberReport report;
+            report.label = m_configs[i].label;
+            report.final_share = shares[i];
+            report.steps = steps_run[i];
+            report.evaluations = members[i]->evaluations();
+            if (members[i]->has_best_ever()) report.best = members[i]->get_best_ever();
+            result.members.push_back(report);
+
+            if (members[i]->has_best_ever() &&
+                (result.best_member == -1 || better_member(*members[i], *members[result.best_member]))) {
+                result.best_member = i;
+            }
+        }
+        if (result.best_member >= 0) result.best = members[result.best_member]->get_best_ever();
+        return result;
+    }
+
+private:
+    int n_variables;
+    std::vector<double> lower_bounds;
+    std::vector<double> upper_bounds;
+    Civilization::ObjFunc m_objective_fn;
+    Civilization::ConFunc m_constraint_fn;
+    std::vector<Config> m_configs;
+    unsigned int m_seed;
+
+    int m_epoch_steps = 5;
+    double m_transfer_rate = 0.25;
+    double m_min_share = 0.05;
+    bool m_share_elites = false;
+    bool m_has_target = false;
+    double m_target = 0.0;
+
+    static bool better_member(const Civilization& a, const Civilization& b) {
+        if (!a.has_best_ever()) return false;
+        if (!b.has_best_ever()) return true;
+        return Civilization::is_better_solution(a.get_best_ever(), b.get_best_ever());
+    }
+};
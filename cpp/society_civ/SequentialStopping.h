@@ -0,0 +1,135 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+// Stopping rule for multi-run studies: keep adding runs until the confidence
+// interval of the quantity under study is narrower than a target width, or a
+// run cap is reached.
+//
+// The quantity is either the mean best objective (Student-t interval) or,
+// with a success threshold, the rate of runs whose best is feasible and at or
+// below the threshold (Wilson score interval, which stays sensible at rates
+// of 0 and 1). Results are fed in run order, so a study with fixed seeds
+// stops after the same number of runs however many run in parallel.
+class SequentialStopping {
+public:
+    struct Config {
+        double ci_width = 0.0;          // target full width of the interval
+        double confidence = 0.95;
+        bool use_success_rate = false;
+        double success_threshold = 0.0; // objective at or below which a run succeeds
+        int min_runs = 5;
+        int max_runs = 200;
+    };
+
+    explicit SequentialStopping(const Config& config) : m_config(config) {
+        if (config.ci_width <= 0.0) throw std::invalid_argument("SequentialStopping: ci_width must be positive");
+        if (config.confidence <= 0.0 || config.confidence >= 1.0) {
+            throw std::invalid_argument("SequentialStopping: confidence must be in (0, 1)");
+        }
+        m_config.min_runs = std::max(2, config.min_runs);
+        m_config.max_runs = std::max(m_config.min_runs, config.max_runs);
+    }
+
+    const Config& config() const { return m_config; }
+
+    void add(double best_objective, bool feasible) {
+        m_runs++;
+        const double delta = best_objective - m_mean;
+        m_mean += delta / m_runs;
+        m_m2 += delta * (best_objective - m_mean);
+        if (feasible && best_objective <= m_config.success_threshold) m_successes++;
+    }
+
+    int runs() const { return m_runs; }
+    double mean() const { return m_mean; }
+    double success_rate() const { return m_runs ? static_cast<double>(m_successes) / m_runs : 0.0; }
+
+    // Centre and half width of the current interval
+    double estimate() const {
+        if (!m_config.use_success_rate) return m_mean;
+        const double z = normal_quantile(0.5 + 0.5 * m_config.confidence);
+        const double n = m_runs, p = success_rate();
+        return n > 0 ? (p + z * z / (2 * n)) / (1 + z * z / n) : 0.0;
+    }
+    double half_width() const {
+        if (m_runs < 2) return INFINITY;
+        const double q = 0.5 + 0.5 * m_config.confidence;
+        if (m_config.use_success_rate) {
+            const double z = normal_quantile(q);
+            const double n = m_runs, p = success_rate();
+            return z * std::sqrt(p * (1 - p) / n + z * z / (4 * n * n)) / (1 + z * z / n);
+        }
+        return t_quantile(q, m_runs - 1) * std::sqrt(m_m2 / (m_runs - 1) / m_runs);
+    }
+
+    bool converged() const { return m_runs >= m_config.min_runs && 2.0 * half_width() <= m_config.ci_width; }
+    bool done() const { return converged() || m_runs >= m_config.max_runs; }
+
+    // Runs to schedule next: enough to reach min_runs, at least 'parallelism'
+    // so every worker stays busy, never past the cap
+    int next_batch(int parallelism) const {
+        if (done()) return 0;
+        const int wanted = std::max(m_config.min_runs - m_runs, std::max(parallelism, 1));
+        return std::min(wanted, m_config.max_runs - m_runs);
+    }
+
+    // Standard normal quantile, by bisection on erfc
+    static double normal_quantile(double p) {
+        double lo = -10.0, hi = 10.0;
+        for (int k = 0; k < 100; ++k) {
+            const double mid = 0.5 * (lo + hi);
+            if (0.5 * std::erfc(-mid / std::sqrt(2.0)) < p) lo = mid;
+            else hi = mid;
+        }
+        return 0.5 * (lo + hi);
+    }
+
+    // Student t CDF for integer degrees of freedom, from the closed-form
+    // finite series in theta = atan(t / sqrt(dof)) (Abramowitz & Stegun 26.7.3-4)
+    static double t_cdf(double t, int dof) {
+        const double theta = std::atan(std::fabs(t) / std::sqrt(static_cast<double>(dof)));
+        const double s = std::sin(theta), c2 = std::cos(theta) * std::cos(theta);
+        double a; // P(|T| < |t|)
+        if (dof % 2) {
+            double term = std::sqrt(c2), sum = dof > 1 ? term : 0.0;
+            for (int k = 3; k < dof; k += 2) {
+                term *= c2 * (k - 1) / k;
+                sum += term;
+            }
+            a = 2.0 / std::acos(-1.0) * (theta + s * sum);
+        }
+        else {
+            double term = 1.0, sum = 1.0;
+            for (int k = 2; k < dof; k += 2) {
+                term *= c2 * (k - 1) / k;
+                sum += term;
+            }
+            a = s * sum;
+        }
+        return t < 0 ? 0.5 - 0.5 * a : 0.5 + 0.5 * a;
+    }
+
+    // Student t quantile, by bisection on t_cdf (exact for every dof; the
+    // normal approximation is far off for the first few runs: 12.71 instead
+    // of 1.96 at dof 1 for a 95% interval)
+    static double t_quantile(double p, int dof) {
+        if (p < 0.5) return -t_quantile(1.0 - p, dof);
+        double lo = 0.0, hi = 1.0;
+        while (t_cdf(hi, dof) < p && hi < 1e12) hi *= 2.0;
+        for (int k = 0; k < 100; ++k) {
+            const double mid = 0.5 * (lo + hi);
+            if (t_cdf(mid, dof) < p) lo = mid;
+            else hi = mid;
+        }
+        return 0.5 * (lo + hi);
+    }
+
+private:
+    Config m_config;
+    int m_runs = 0;
+    int m_successes = 0;
+    double m_mean = 0.0;
+    double m_m2 = 0.0; // sum of squared deviations (Welford)
+};
@@ -0,0 +1,339 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Process-wide work-stealing task runtime.
+//
+// Every parallel layer of the engine (independent runs, societies within a step,
+// evaluations within a society) submits work here instead of owning threads.
+// The runtime starts (max_threads - 1) workers once; the thread that calls
+// parallel_for() is the remaining slot. A caller waiting for its chunks keeps
+// executing queued tasks (its own or anybody else's) until its group is done,
+// so nested parallel_for() calls cannot deadlock and the number of threads
+// doing work never exceeds max_threads. It only sleeps when there is nothing
+// left to run, and wakes when new work is queued or its group finishes.
+class TaskRuntime {
+public:
+    using Task = std::function<void()>;
+
+    // Counters for diagnosing oversubscription
+    struct Stats {
+        unsigned max_threads = 0;     // hard cap (workers + one calling thread)
+        unsigned worker_threads = 0;  // threads actually created by the runtime
+        int peak_active = 0;          // max threads executing engine work at the same time
+        long long tasks_executed = 0; // queued tasks run by workers or helping waiters
+        long long tasks_stolen = 0;   // tasks taken from another worker's deque
+    };
+
+    static TaskRuntime& instance() {
+        static TaskRuntime runtime;
+        return runtime;
+    }
+
+    // Must be called before the first parallel_for(); ignored afterwards.
+    // 0 means std::thread::hardware_concurrency().
+    static void set_max_threads(unsigned n) {
+        requested_threads() = n;
+    }
+
+    unsigned max_threads() const { return m_max_threads; }
+
+    Stats stats() const {
+        Stats s;
+        s.max_threads = m_max_threads;
+        s.worker_threads = static_cast<unsigned>(workers.size());
+        s.peak_active = peak_active.load();
+        s.tasks_executed = tasks_executed.load();
+        s.tasks_stolen = tasks_stolen.load();
+        return s;
+    }
+
+    void reset_stats() {
+        peak_active = active.load();
+        tasks_executed = 0;
+        tasks_stolen = 0;
+    }
+
+    // Runs fn(i) for i in [begin, end). Chunks of at least 'grain' indices are
+    // queued; the caller runs the first chunk itself and then helps until all
+    // chunks finish. The first exception thrown by fn is rethrown here.
+    template <typename Fn>
+    void parallel_for(int begin, int end, Fn&& fn, int grain = 1) {
+        const int count = end - begin;
+        if (count <= 0) return;
+        grain = std::max(grain, 1);
+
+        if (m_max_threads <= 1 || count <= grain) {
+            ActiveScope scope(*this);
+            for (int i = begin; i < end; ++i) fn(i);
+            return;
+        }
+
+        // A few chunks per thread so that stealing can balance uneven work
+        const int max_chunks = static_cast<int>(m_max_threads) * 4;
+        const int chunks = std::min(max_chunks, (count + grain - 1) / grain);
+        const int chunk_size = (count + chunks - 1) / chunks;
+
+        Group group;
+        auto run_chunk = [&group, &fn](int lo, int hi) {
+            try {
+                for (int i = lo; i < hi; ++i) fn(i);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(group.error_mutex);
+                if (!group.error) group.error = std::current_exception();
+            }
+        };
+
+        int first_hi = std::min(end, begin + chunk_size);
+        for (int lo = first_hi; lo < end; lo += chunk_size) {
+            int hi = std::min(end, lo + chunk_size);
+            group.remaining.fetch_add(1);
+            push([this, &group, &run_chunk, lo, hi]() {
+                run_chunk(lo, hi);
+                finish(group);
+            });
+        }
+
+        {
+            ActiveScope scope(*this);
+            run_chunk(begin, first_hi);
+        }
+
+        // Help instead of blocking: this is what keeps nested calls within the cap
+        wait_for(group);
+
+        if (group.error) std::rethrow_exception(group.error);
+    }
+
+    // Runs fn(i) for i = begin, begin + 1, ... with every participating thread
+    // claiming the next index as soon as it becomes free (list scheduling).
+    // Unlike parallel_for, work starts in exactly index order, which is what
+    // longest-predicted-first dispatch relies on.
+    template <typename Fn>
+    void parallel_for_dynamic(int begin, int end, Fn&& fn) {
+        const int count = end - begin;
+        if (count <= 0) return;
+
+        if (m_max_threads <= 1 || count == 1) {
+            ActiveScope scope(*this);
+            for (int i = begin; i < end; ++i) fn(i);
+            return;
+        }
+
+        std::atomic<int> next{ begin };
+        Group group;
+        auto drain = [&group, &next, &fn, end]() {
+            try {
+                for (int i = next.fetch_add(1); i < end; i = next.fetch_add(1)) fn(i);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(group.error_mutex);
+                if (!group.error) group.error = std::current_exception();
+            }
+        };
+
+        const int helpers = std::min(static_cast<int>(m_max_threads), count) - 1;
+        for (int h = 0; h < helpers; ++h) {
+            group.remaining.fetch_add(1);
+            push([this, &group, &drain]() {
+                drain();
+                finish(group);
+            });
+        }
+
+        {
+            ActiveScope scope(*this);
+            drain();
+        }
+
+        wait_for(group);
+
+        if (group.error) std::rethrow_exception(group.error);
+    }
+
+    ~TaskRuntime() {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+            stopping = true;
+        }
+        sleep_cv.notify_all();
+        for (auto& t : workers) t.join();
+    }
+
+    TaskRuntime(const TaskRuntime&) = delete;
+    TaskRuntime& operator=(const TaskRuntime&) = delete;
+
+private:
+    struct Group {
+        std::atomic<int> remaining{ 0 };
+        std::mutex error_mutex;
+        std::exception_ptr error;
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    // Tracks how many threads are executing engine work at once; nested scopes
+    // on the same thread (a task helping inside parallel_for) count once.
+    struct ActiveScope {
+        TaskRuntime& rt;
+        explicit ActiveScope(TaskRuntime& r) : rt(r) {
+            if (depth()++ > 0) return;
+            int now = rt.active.fetch_add(1) + 1;
+            int peak = rt.peak_active.load();
+            while (now > peak && !rt.peak_active.compare_exchange_weak(peak, now)) {}
+        }
+        ~ActiveScope() {
+            if (--depth() == 0) rt.active.fetch_sub(1);
+        }
+        static int& depth() {
+            thread_local int d = 0;
+            return d;
+        }
+    };
+
+    unsigned m_max_threads = 1;
+    std::vector<std::thread> workers;
+    // queues[0] is the injection queue for threads the runtime does not own;
+    // queues[k] (k >= 1) belongs to worker k.
+    std::vector<std::unique_ptr<Queue>> queues;
+
+    std::atomic<int> queued{ 0 };
+    std::atomic<int> active{ 0 };
+    std::atomic<int> peak_active{ 0 };
+    std::atomic<long long> tasks_executed{ 0 };
+    std::atomic<long long> tasks_stolen{ 0 };
+
+    std::mutex sleep_mutex;
+    std::condition_variable sleep_cv;
+    bool stopping = false;
+
+    static unsigned& requested_threads() {
+        static unsigned n = 0;
+        return n;
+    }
+
+    // Index of this thread's own queue (0 for non-worker threads)
+    static int& worker_index() {
+        thread_local int index = 0;
+        return index;
+    }
+
+    TaskRuntime() {
+        unsigned n = requested_threads();
+        if (n == 0) n = std::thread::hardware_concurrency();
+        m_max_threads = std::max(1u, n);
+
+        queues.reserve(m_max_threads);
+        for (unsigned i = 0; i < m_max_threads; ++i) queues.push_back(std::make_unique<Queue>());
+
+        workers.reserve(m_max_threads - 1);
+        for (unsigned k = 1; k < m_max_threads; ++k) {
+            workers.emplace_back([this, k]() { worker_loop(static_cast<int>(k)); });
+        }
+    }
+
+    void push(Task task) {
+        Queue& q = *queues[worker_index()];
+        {
+            std::lock_guard<std::mutex> lock(q.mutex);
+            q.tasks.push_back(std::move(task));
+        }
+        {
+            // Taking the lock orders this push against a worker about to sleep
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+            queued.fetch_add(1);
+        }
+        sleep_cv.notify_one();
+    }
+
+    // Own queue LIFO (cache-warm), then the injection queue, then steal FIFO
+    bool try_pop(Task& out) {
+        const int self = worker_index();
+        {
+            Queue& q = *queues[self];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (!q.tasks.empty()) {
+                out = std::move(q.tasks.back());
+                q.tasks.pop_back();
+                return true;
+            }
+        }
+        const int n = static_cast<int>(queues.size());
+        for (int k = 1; k <= n; ++k) {
+            int victim = (self + k) % n;
+            Queue& q = *queues[victim];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (!q.tasks.empty()) {
+                out = std::move(q.tasks.front());
+                q.tasks.pop_front();
+                if (victim != 0) tasks_stolen.fetch_add(1);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool try_run_one() {
+        Task task;
+        if (!try_pop(task)) return false;
+        queued.fetch_sub(1);
+        {
+            ActiveScope scope(*this);
+            task();
+        }
+        tasks_executed.fetch_add(1);
+        return true;
+    }
+
+    // Marks one queued task of 'group' done; the last one wakes its waiter.
+    // 'group' may be destroyed as soon as the count reaches zero.
+    void finish(Group& group) {
+        if (group.remaining.fetch_sub(1) != 1) return;
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        sleep_cv.notify_all();
+    }
+
+    // Runs queued tasks until 'group' is done. With nothing to run, the caller
+    // yields for a short while (chunks usually finish soon) and then parks on
+    // sleep_cv until a task is queued or the group's last task finishes.
+    void wait_for(Group& group) {
+        static constexpr int SPIN_YIELDS = 64;
+        int idle = 0;
+        while (group.remaining.load() > 0) {
+            if (try_run_one()) {
+                idle = 0;
+                continue;
+            }
+            if (++idle < SPIN_YIELDS) {
+                std::this_thread::yield();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleep_mutex);
+            sleep_cv.wait(lock, [this, &group]() { return group.remaining.load() == 0 || queued.load() > 0; });
+            idle = 0;
+        }
+    }
+
+    void worker_loop(int index) {
+        worker_index() = index;
+        while (true) {
+            if (try_run_one()) continue;
+
+            std::unique_lock<std::mutex> lock(sleep_mutex);
+            sleep_cv.wait(lock, [this]() { return stopping || queued.load() > 0; });
+            if (stopping) return;
+        }
+    }
+};
@@ -0,0 +1,226 @@
+#pragma once
+#include "TaskRuntime.h"
+#include "TrajectoryLog.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Standard post-run metrics over a trajectory log, computed run by run in
+// parallel on the shared TaskRuntime.
+//
+// Society ids are re-drawn at every clustering step, so turnover questions
+// are answered without comparing ids across steps:
+//   - an agent switched society if fewer than half of its previous
+//     society-mates are in its current society (agents that were alone
+//     never count as switching);
+//   - super-leader turnover is 1 - |S(t) & S(t-1)| / |S(t) | S(t-1)|, over
+//     agent ids;
+//   - with an influence column, the top basin share is the fraction of
+//     agents whose chain of moves ends at the same root (see InfluenceTree).
+// The log carries no constraint violations, so "best" is the lowest logged
+// objective, feasible or not.
+class TrajectoryAnalytics {
+public:
+    struct StepMetrics {
+        int32_t run = 0;
+        int32_t time = 0;
+        int agents = 0;
+        double best = 0.0;          // lowest objective at this step
+        double best_so_far = 0.0;   // convergence curve
+        double mean = 0.0;
+        int societies = 0;
+        int local_leaders = 0;
+        int super_leaders = 0;
+        double super_turnover = 0.0; // 0 at the first step
+        int switches = 0;            // agents that changed society since the previous step
+        double top_basin_share = 0.0; // logs with influence: share of agents in the largest InfluenceTree basin
+    };
+
+    struct RunMetrics {
+        int32_t run = 0;
+        int steps = 0;
+        double final_best = 0.0;
+        int32_t time_of_best = 0;   // first step at which final_best was reached
+        double mean_societies = 0.0;
+        double mean_super_turnover = 0.0;
+        double switch_rate = 0.0;   // switches per agent per step
+    };
+
+    std::vector<StepMetrics> steps; // ordered by run, then time
+    std::vector<RunMetrics> runs;   // ordered by run
+
+    void compute(const TrajectoryLog& log) {
+        // Row blocks of each run, ordered by time (split steps are merged)
+        std::map<int32_t, std::map<int32_t, std::vector<TrajectoryLog::Step>>> by_run;
+        for (const auto& s : log.steps()) by_run[s.run][s.time].push_back(s);
+
+        using RunSteps = std::map<int32_t, std::vector<TrajectoryLog::Step>>;
+        std::vector<std::pair<int32_t, const RunSteps*>> run_list;
+        for (const auto& r : by_run) run_list.push_back({ r.first, &r.second });
+
+        std::vector<std::vector<StepMetrics>> per_run(run_list.size());
+        runs.assign(run_list.size(), RunMetrics());
+        TaskRuntime::instance().parallel_for_dynamic(0, static_cast<int>(run_list.size()), [&](int k) {
+            analyse_run(log, run_list[k].first, *run_list[k].second, per_run[k], runs[k]);
+        });
+
+        steps.clear();
+        for (auto& r : per_run) steps.insert(steps.end(), r.begin(), r.end());
+    }
+
+    void write_steps_csv(const std::string& path) const {
+        std::ofstream out(path);
+        if (!out) throw std::runtime_error("TrajectoryAnalytics: cannot write '" + path + "'");
+        out << "Run,Time,Agents,Best,BestSoFar,Mean,Societies,LocalLeaders,SuperLeaders,SuperTurnover,Switches,TopBasinShare\n";
+        out << std::setprecision(10);
+        for (const auto& s : steps) {
+            out << s.run << "," << s.time << "," << s.agents << "," << s.best << "," << s.best_so_far << ","
+                << s.mean << "," << s.societies << "," << s.local_leaders << "," << s.super_leaders << ","
+                << s.super_turnover << "," << s.switches << "," << s.top_basin_share << "\n";
+        }
+    }
+
+    void write_runs_csv(const std::string& path) const {
+        std::ofstream out(path);
+        if (!out) throw std::runtime_error("TrajectoryAnalytics: cannot write '" + path + "'");
+        out << "Run,Steps,FinalBest,TimeOfBest,MeanSocieties,MeanSuperTurnover,SwitchRate\n";
+        out << std::setprecision(10);
+        for (const auto& r : runs) {
+            out << r.run << "," << r.steps << "," << r.final_best << "," << r.time_of_best << ","
+                << r.mean_societies << "," << r.mean_super_turnover << "," << r.switch_rate << "\n";
+        }
+    }
+
+private:
+    static void analyse_run(const TrajectoryLog& log, int32_t run,
+        const std::map<int32_t, std::vector<TrajectoryLog::Step>>& run_steps,
+        std::vector<StepMetrics>& out, RunMetrics& summary) {
+        // Per-agent state from the previous step (index = agent id)
+        std::vector<int32_t> prev_cluster, cur_cluster;
+        std::vector<char> prev_super, cur_super;
+        std::unordered_map<int32_t, int> prev_sizes, cur_sizes;
+        std::unordered_map<uint64_t, int> overlap; // (previous, current) society pair -> agents
+        std::vector<int32_t> seen_agents;
+        std::vector<int32_t> moved_toward; // influence of the current step, by agent
+        std::unordered_map<int32_t, int> basin;
+
+        double best_so_far = std::numeric_limits<double>::infinity();
+        long long total_switches = 0, agent_steps = 0;
+        summary.run = run;
+
+        for (const auto& entry : run_steps) {
+            StepMetrics m;
+            m.run = run;
+            m.time = entry.first;
+            m.best = std::numeric_limits<double>::infinity();
+
+            cur_sizes.clear();
+            seen_agents.clear();
+            double sum = 0.0;
+            for (const auto& block : entry.second) {
+                for (uint64_t i = block.first; i < block.first + block.count; ++i) {
+                    const int32_t a = log.agent[i];
+                    if (a >= (int32_t)cur_cluster.size()) {
+                        cur_cluster.resize(a + 1, -1);
+                        cur_super.resize(a + 1, 0);
+                        prev_cluster.resize(a + 1, -1);
+                        prev_super.resize(a + 1, 0);
+                    }
+                    if (log.has_influence()) {
+                        if (a >= (int32_t)moved_toward.size()) moved_toward.resize(a + 1, -1);
+                        moved_toward[a] = log.influence[i];
+                    }
+                    cur_cluster[a] = log.cluster[i];
+                    cur_super[a] = (log.flags[i] & TrajectoryLog::SUPER_LEADER) ? 1 : 0;
+                    seen_agents.push_back(a);
+
+                    m.agents++;
+                    sum += log.objective[i];
+                    m.best = std::min(m.best, log.objective[i]);
+                    cur_sizes[log.cluster[i]]++;
+                    if (log.flags[i] & TrajectoryLog::LOCAL_LEADER) m.local_leaders++;
+                    if (log.flags[i] & TrajectoryLog::SUPER_LEADER) m.super_leaders++;
+                }
+            }
+            m.mean = m.agents ? sum / m.agents : 0.0;
+            if (log.has_influence() && m.agents > 0) {
+                basin.clear();
+                int largest = 0;
+                for (int32_t a : seen_agents) {
+                    int32_t r = a;
+                    for (int hops = 0; hops < 64; ++hops) {
+                        const int32_t up = moved_toward[r];
+                        if (up < 0 || up >= (int32_t)moved_toward.size() || up == a) break;
+                        r = up;
+                    }
+                    largest = std::max(largest, ++basin[r]);
+                }
+                m.top_basin_share = static_cast<double>(largest) / m.agents;
+                for (int32_t a : seen_agents) moved_toward[a] = -1;
+            }
+            m.societies = static_cast<int>(cur_sizes.size());
+            best_so_far = std::min(best_so_far, m.best);
+            m.best_so_far = best_so_far;
+
+            if (!out.empty()) {
+                // Super-leader turnover (Jaccard distance over agent ids)
+                int both = 0, either = 0;
+                for (size_t a = 0; a < cur_super.size(); ++a) {
+                    both += cur_super[a] && prev_super[a];
+                    either += cur_super[a] || prev_super[a];
+                }
+                m.super_turnover = either ? 1.0 - static_cast<double>(both) / either : 0.0;
+
+                // Society switches via co-membership
+                overlap.clear();
+                for (int32_t a : seen_agents) {
+                    if (prev_sizes.find(prev_cluster[a]) == prev_sizes.end()) continue; // new agent
+                    overlap[pair_key(prev_cluster[a], cur_cluster[a])]++;
+                }
+                for (int32_t a : seen_agents) {
+                    auto size = prev_sizes.find(prev_cluster[a]);
+                    if (size == prev_sizes.end() || size->second <= 1) continue;
+                    const int mates_before = size->second - 1;
+                    const int mates_kept = overlap[pair_key(prev_cluster[a], cur_cluster[a])] - 1;
+                    if (2 * mates_kept < mates_before) m.switches++;
+                }
+                total_switches += m.switches;
+                agent_steps += m.agents;
+            }
+
+            summary.mean_societies += m.societies;
+            summary.mean_super_turnover += m.super_turnover;
+            out.push_back(m);
+
+            std::swap(prev_cluster, cur_cluster);
+            std::swap(prev_super, cur_super);
+            std::swap(prev_sizes, cur_sizes);
+            std::fill(cur_cluster.begin(), cur_cluster.end(), -1);
+            std::fill(cur_super.begin(), cur_super.end(), 0);
+        }
+
+        summary.steps = static_cast<int>(out.size());
+        if (summary.steps > 0) {
+            summary.final_best = best_so_far;
+            summary.mean_societies /= summary.steps;
+            summary.mean_super_turnover = summary.steps > 1 ? summary.mean_super_turnover / (summary.steps - 1) : 0.0;
+            summary.switch_rate = agent_steps ? static_cast<double>(total_switches) / agent_steps : 0.0;
+            for (const auto& m : out) {
+                if (m.best_so_far == best_so_far) { summary.time_of_best = m.time; break; }
+            }
+        }
+    }
+
+    static uint64_t pair_key(int32_t before, int32_t after) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(before)) << 32) | static_cast<uint32_t>(after);
+    }
+};
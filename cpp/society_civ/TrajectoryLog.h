@@ -0,0 +1,491 @@
+#pragma once
+#include "BlockWriter.h"
+#include "TaskRuntime.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Trajectory logs as written by Civilization::log_state():
+//   Run,Time,AgentID,x1,x2,Objective,ClusterID,IsLocalLeader,IsSuperLeader
+// optionally followed by InfluencedBy (the agent moved toward, -1 for none)
+// when the civilization tracks influence.
+//
+// parse_csv() memory-maps the file, splits it into line-aligned chunks that
+// are parsed concurrently on the shared TaskRuntime with a hand-written
+// number parser, and validates every row. The result is kept column-wise.
+//
+// The binary format stores the same table compactly: Run and Time are kept
+// once per step in an index of (run, time, first row, row count) blocks, and
+// the two role flags share one byte. A step can therefore be located without
+// scanning the rows. The influence column, when present, is one int32 per row.
+class TrajectoryLog {
+public:
+    static constexpr const char* CSV_HEADER = "Run,Time,AgentID,x1,x2,Objective,ClusterID,IsLocalLeader,IsSuperLeader";
+    static constexpr const char* CSV_HEADER_INFLUENCE =
+        "Run,Time,AgentID,x1,x2,Objective,ClusterID,IsLocalLeader,IsSuperLeader,InfluencedBy";
+    enum Flags : uint8_t { LOCAL_LEADER = 1, SUPER_LEADER = 2 };
+
+    // Consecutive rows of one (run, time) step
+    struct Step {
+        int32_t run;
+        int32_t time;
+        uint64_t first;
+        uint64_t count;
+    };
+
+    struct ParseReport {
+        uint64_t bytes = 0;
+        uint64_t rows = 0;
+        long long errors = 0;              // rejected lines
+        long long split_steps = 0;         // steps whose rows are not contiguous
+        std::vector<std::string> messages; // first few problems, with line numbers
+        bool ok() const { return errors == 0; }
+    };
+
+    // Columns, one entry per row
+    std::vector<int32_t> run, time, agent, cluster;
+    std::vector<double> x1, x2, objective;
+    std::vector<uint8_t> flags;
+    std::vector<int32_t> influence; // empty unless the log has an InfluencedBy column
+
+    size_t size() const { return agent.size(); }
+    bool has_influence() const { return m_has_influence; }
+    const std::vector<Step>& steps() const { return m_steps; }
+
+    // Parses a CSV log; 'chunks' = 0 uses four chunks per runtime thread.
+    // Invalid lines are skipped and reported.
+    ParseReport parse_csv(const std::string& path, int chunks = 0) {
+        MappedFile file(path);
+        ParseReport report;
+        report.bytes = file.size();
+        clear();
+
+        const char* begin = file.data();
+        const char* end = begin + file.size();
+        const char* body = static_cast<const char*>(std::memchr(begin, '\n', file.size()));
+        body = body ? body + 1 : end;
+        std::string header(begin, body - begin);
+        while (!header.empty() && (header.back() == '\n' || header.back() == '\r')) header.pop_back();
+        const bool with_influence = header == CSV_HEADER_INFLUENCE;
+        if (header != CSV_HEADER && !with_influence) {
+            report.errors++;
+            report.messages.push_back("line 1: unexpected header '" + header + "'");
+            return report;
+        }
+
+        TaskRuntime& runtime = TaskRuntime::instance();
+        if (chunks <= 0) chunks = 4 * static_cast<int>(runtime.max_threads());
+        const size_t body_bytes = static_cast<size_t>(end - body);
+        chunks = static_cast<int>(std::max<size_t>(1, std::min<size_t>(chunks, body_bytes / (1 << 16) + 1)));
+
+        // Chunk k starts after the first newline at or past k * body_bytes / chunks
+        // (bounds are non-decreasing, so empty chunks are possible but harmless)
+        std::vector<const char*> bounds(chunks + 1, end);
+        bounds[0] = body;
+        for (int k = 1; k < chunks; ++k) {
+            const char* at = body + body_bytes * k / chunks;
+            const char* nl = static_cast<const char*>(std::memchr(at, '\n', end - at));
+            bounds[k] = nl ? nl + 1 : end;
+        }
+
+        std::vector<TrajectoryLog> parts(chunks);
+        std::vector<ChunkResult> results(chunks);
+        for (TrajectoryLog& part : parts) part.m_has_influence = with_influence;
+        m_has_influence = with_influence;
+        runtime.parallel_for(0, chunks, [&](int k) {
+            results[k] = parts[k].parse_rows(bounds[k], bounds[k + 1]);
+        });
+
+        // Concatenate, turning chunk-local line numbers into file line numbers
+        std::vector<size_t> offset(chunks + 1, 0);
+        long long line = 1;
+        for (int k = 0; k < chunks; ++k) {
+            offset[k + 1] = offset[k] + parts[k].size();
+            report.errors += results[k].errors;
+            for (const auto& e : results[k].first_errors) {
+                if (report.messages.size() < MAX_MESSAGES) {
+                    report.messages.push_back("line " + std::to_string(line + e.first) + ": " + e.second);
+                }
+            }
+            line += results[k].lines;
+        }
+        resize(offset[chunks]);
+        runtime.parallel_for(0, chunks, [&](int k) {
+            const TrajectoryLog& p = parts[k];
+            const size_t at = offset[k];
+            std::copy(p.run.begin(), p.run.end(), run.begin() + at);
+            std::copy(p.time.begin(), p.time.end(), time.begin() + at);
+            std::copy(p.agent.begin(), p.agent.end(), agent.begin() + at);
+            std::copy(p.cluster.begin(), p.cluster.end(), cluster.begin() + at);
+            std::copy(p.x1.begin(), p.x1.end(), x1.begin() + at);
+            std::copy(p.x2.begin(), p.x2.end(), x2.begin() + at);
+            std::copy(p.objective.begin(), p.objective.end(), objective.begin() + at);
+            std::copy(p.flags.begin(), p.flags.end(), flags.begin() + at);
+            std::copy(p.influence.begin(), p.influence.end(), influence.begin() + at);
+        });
+
+        report.rows = size();
+        report.split_steps = build_steps();
+        if (report.split_steps > 0 && report.messages.size() < MAX_MESSAGES) {
+            report.messages.push_back(std::to_string(report.split_steps) + " step(s) are split across non-contiguous rows");
+        }
+        return report;
+    }
+
+    void write_binary(const std::string& path) const {
+        BlockWriter out(path);
+        BinaryHeader h{};
+        std::memcpy(h.magic, MAGIC, sizeof(h.magic));
+        h.version = VERSION;
+        h.columns = m_has_influence ? INFLUENCE_COLUMN : 0;
+        h.rows = size();
+        h.steps = m_steps.size();
+        out.write(&h, sizeof(h));
+        write_column(out, m_steps);
+        write_column(out, agent);
+        write_column(out, cluster);
+        write_column(out, x1);
+        write_column(out, x2);
+        write_column(out, objective);
+        write_column(out, flags);
+        if (m_has_influence) write_column(out, influence);
+        out.close();
+    }
+
+    void read_binary(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        BinaryHeader h{};
+        if (!in.read(reinterpret_cast<char*>(&h), sizeof(h)) || std::memcmp(h.magic, MAGIC, sizeof(h.magic)) != 0 ||
+            h.version < 1 || h.version > VERSION) {
+            throw std::runtime_error("TrajectoryLog: '" + path + "' is not a trajectory file");
+        }
+
+        // The header's counts must account for the file's length exactly
+        // before anything is allocated from them
+        const bool influence_column = (h.columns & INFLUENCE_COLUMN) != 0;
+        const uint64_t row_bytes = 2 * sizeof(int32_t) + 3 * sizeof(double) + sizeof(uint8_t) +
+            (influence_column ? sizeof(int32_t) : 0);
+        in.seekg(0, std::ios::end);
+        const std::streamoff end = in.tellg();
+        in.seekg(sizeof(h), std::ios::beg);
+        const uint64_t payload = end > static_cast<std::streamoff>(sizeof(h)) ? static_cast<uint64_t>(end) - sizeof(h) : 0;
+        if (!in || h.steps > payload / sizeof(Step) || h.rows > payload / row_bytes ||
+            h.steps * sizeof(Step) + h.rows * row_bytes != payload) {
+            throw std::runtime_error("TrajectoryLog: '" + path + "' is truncated or its header is corrupt");
+        }
+
+        clear();
+        m_has_influence = influence_column;
+        m_steps.resize(h.steps);
+        resize(h.rows);
+        read_column(in, m_steps);
+        read_column(in, agent);
+        read_column(in, cluster);
+        read_column(in, x1);
+        read_column(in, x2);
+        read_column(in, objective);
+        read_column(in, flags);
+        if (m_has_influence) read_column(in, influence);
+        if (!in) throw std::runtime_error("TrajectoryLog: '" + path + "' is truncated");
+
+        for (const Step& s : m_steps) {
+            if (s.first > h.rows || s.count > h.rows - s.first) throw std::runtime_error("TrajectoryLog: corrupt step index in '" + path + "'");
+            std::fill(run.begin() + s.first, run.begin() + s.first + s.count, s.run);
+            std::fill(time.begin() + s.first, time.begin() + s.first + s.count, s.time);
+        }
+    }
+
+    // Blocks of one step, in file order (usually exactly one)
+    std::vector<Step> find_step(int32_t r, int32_t t) const {
+        std::vector<Step> found;
+        for (const Step& s : m_steps) {
+            if (s.run == r && s.time == t) found.push_back(s);
+        }
+        return found;
+    }
+
+    // Parses a decimal floating-point number. Up to 19 significant digits
+    // with a power-of-ten exponent within +-22 are converted exactly with one
+    // multiplication or division; anything else (including inf/nan) goes to
+    // strtod. Leaves p after the number.
+    static bool parse_double(const char*& p, const char* end, double& out) {
+        static const double POW10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+        const char* start = p;
+        bool negative = false;
+        if (p < end && (*p == '-' || *p == '+')) negative = (*p++ == '-');
+
+        uint64_t mantissa = 0;
+        int digits = 0, exponent = 0;
+        bool seen_digit = false, truncated = false;
+        for (; p < end && unsigned(*p - '0') < 10; ++p) {
+            seen_digit = true;
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (*p - '0');
+                if (mantissa) digits++;
+            }
+            else {
+                exponent++;
+                truncated = true;
+            }
+        }
+        if (p < end && *p == '.') {
+            for (++p; p < end && unsigned(*p - '0') < 10; ++p) {
+                seen_digit = true;
+                if (digits < 19) {
+                    mantissa = mantissa * 10 + (*p - '0');
+                    if (mantissa) digits++;
+                    exponent--;
+                }
+                else {
+                    truncated = true;
+                }
+            }
+        }
+        if (seen_digit && p < end && (*p == 'e' || *p == 'E')) {
+            const char* e = p + 1;
+            bool negative_exp = false;
+            if (e < end && (*e == '-' || *e == '+')) negative_exp = (*e++ == '-');
+            if (e < end && unsigned(*e - '0') < 10) {
+                int value = 0;
+                for (; e < end && unsigned(*e - '0') < 10; ++e) value = std::min(value * 10 + (*e - '0'), 100000);
+                exponent += negative_exp ? -value : value;
+                p = e;
+            }
+        }
+
+        if (seen_digit && !truncated && mantissa < (1ull << 53) && exponent >= -22 && exponent <= 22) {
+            const double m = static_cast<double>(mantissa);
+            out = exponent < 0 ? m / POW10[-exponent] : m * POW10[exponent];
+            if (negative) out = -out;
+            return true;
+        }
+
+        // Slow path on a bounded, NUL-terminated copy of the field
+        const char* field_end = start;
+        while (field_end < end && *field_end != ',' && *field_end != '\n' && *field_end != '\r') ++field_end;
+        char text[64];
+        const size_t length = static_cast<size_t>(field_end - start);
+        if (length == 0 || length >= sizeof(text)) return false;
+        std::memcpy(text, start, length);
+        text[length] = '\0';
+        char* parsed_end;
+        out = std::strtod(text, &parsed_end);
+        if (parsed_end == text) return false;
+        p = start + (parsed_end - text);
+        return true;
+    }
+
+    static bool parse_int(const char*& p, const char* end, int32_t& out) {
+        bool negative = false;
+        if (p < end && *p == '-') { negative = true; ++p; }
+        if (p >= end || unsigned(*p - '0') >= 10) return false;
+        int64_t value = 0;
+        for (; p < end && unsigned(*p - '0') < 10; ++p) {
+            value = value * 10 + (*p - '0');
+            if (value > INT32_MAX) return false;
+        }
+        out = static_cast<int32_t>(negative ? -value : value);
+        return true;
+    }
+
+private:
+    static constexpr char MAGIC[8] = { 'C', 'I', 'V', 'T', 'R', 'J', '0', '1' };
+    static constexpr uint32_t VERSION = 2; // 2: optional columns (version 1 files have none)
+    static constexpr uint32_t INFLUENCE_COLUMN = 1;
+    static constexpr size_t MAX_MESSAGES = 10;
+
+    struct BinaryHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t columns; // optional columns present (INFLUENCE_COLUMN)
+        uint64_t rows;
+        uint64_t steps;
+    };
+
+    struct ChunkResult {
+        long long lines = 0;
+        long long errors = 0;
+        std::vector<std::pair<long long, std::string>> first_errors; // chunk-local line, message
+    };
+
+    // Read-only mapping of a whole file
+    class MappedFile {
+    public:
+        explicit MappedFile(const std::string& path) {
+#ifdef _WIN32
+            file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            if (file == INVALID_HANDLE_VALUE) throw std::runtime_error("TrajectoryLog: cannot open '" + path + "'");
+            LARGE_INTEGER size;
+            GetFileSizeEx(file, &size);
+            m_size = static_cast<size_t>(size.QuadPart);
+            if (m_size) {
+                mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                m_data = mapping ? static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+            }
+#else
+            fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) throw std::runtime_error("TrajectoryLog: cannot open '" + path + "'");
+            struct stat st;
+            fstat(fd, &st);
+            m_size = static_cast<size_t>(st.st_size);
+            if (m_size) {
+                void* base = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (base != MAP_FAILED) {
+                    m_data = static_cast<const char*>(base);
+                    madvise(base, m_size, MADV_SEQUENTIAL);
+                }
+            }
+#endif
+            if (m_size && !m_data) {
+                release();
+                throw std::runtime_error("TrajectoryLog: cannot map '" + path + "'");
+            }
+        }
+        ~MappedFile() { release(); }
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        const char* data() const { return m_data ? m_data : ""; }
+        size_t size() const { return m_size; }
+
+    private:
+        const char* m_data = nullptr;
+        size_t m_size = 0;
+#ifdef _WIN32
+        HANDLE file = INVALID_HANDLE_VALUE;
+        HANDLE mapping = nullptr;
+#else
+        int fd = -1;
+#endif
+
+        void release() {
+#ifdef _WIN32
+            if (m_data) UnmapViewOfFile(m_data);
+            if (mapping) CloseHandle(mapping);
+            if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+            m_data = nullptr;
+            mapping = nullptr;
+            file = INVALID_HANDLE_VALUE;
+#else
+            if (m_data) munmap(const_cast<char*>(m_data), m_size);
+            if (fd >= 0) ::close(fd);
+            m_data = nullptr;
+            fd = -1;
+#endif
+        }
+    };
+
+    std::vector<Step> m_steps;
+    bool m_has_influence = false;
+
+    void clear() {
+        resize(0);
+        m_steps.clear();
+        m_has_influence = false;
+    }
+
+    void resize(size_t rows) {
+        run.resize(rows); time.resize(rows); agent.resize(rows); cluster.resize(rows);
+        x1.resize(rows); x2.resize(rows); objective.resize(rows); flags.resize(rows);
+        influence.resize(m_has_influence ? rows : 0);
+    }
+
+    // Parses complete lines in [p, end) into this (empty) table
+    ChunkResult parse_rows(const char* p, const char* end) {
+        ChunkResult result;
+        const size_t expected = static_cast<size_t>(end - p) / 32 + 1;
+        run.reserve(expected); time.reserve(expected); agent.reserve(expected); cluster.reserve(expected);
+        x1.reserve(expected); x2.reserve(expected); objective.reserve(expected); flags.reserve(expected);
+        if (m_has_influence) influence.reserve(expected);
+
+        while (p < end) {
+            const char* line_end = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            if (!line_end) line_end = end;
+            const char* stop = (line_end > p && line_end[-1] == '\r') ? line_end - 1 : line_end;
+            result.lines++;
+
+            if (stop > p) {
+                const char* error = parse_row(p, stop);
+                if (error) {
+                    if (result.first_errors.size() < MAX_MESSAGES) result.first_errors.push_back({ result.lines, error });
+                    result.errors++;
+                }
+            }
+            p = line_end + 1;
+        }
+        return result;
+    }
+
+    // Appends one row; returns an error message instead when the line is invalid
+    const char* parse_row(const char* p, const char* end) {
+        int32_t r, t, a, c, local, super, by = -1;
+        double v1, v2, f;
+        auto separator = [&]() { return p < end && *p++ == ','; };
+        if (!parse_int(p, end, r) || !separator() || !parse_int(p, end, t) || !separator() ||
+            !parse_int(p, end, a) || !separator()) return "bad Run/Time/AgentID";
+        if (!parse_double(p, end, v1) || !separator() || !parse_double(p, end, v2) || !separator() ||
+            !parse_double(p, end, f) || !separator()) return "bad x1/x2/Objective";
+        if (!parse_int(p, end, c) || !separator() || !parse_int(p, end, local) || !separator() ||
+            !parse_int(p, end, super)) return "bad ClusterID/IsLocalLeader/IsSuperLeader";
+        if (m_has_influence && (!separator() || !parse_int(p, end, by) || by < -1)) return "bad InfluencedBy";
+        if (p != end) return "unexpected trailing fields";
+        if (r < 0 || t < 0 || a < 0) return "negative Run/Time/AgentID";
+        if ((local != 0 && local != 1) || (super != 0 && super != 1)) return "leader flags must be 0 or 1";
+
+        run.push_back(r); time.push_back(t); agent.push_back(a); cluster.push_back(c);
+        x1.push_back(v1); x2.push_back(v2); objective.push_back(f);
+        flags.push_back(static_cast<uint8_t>((local ? LOCAL_LEADER : 0) | (super ? SUPER_LEADER : 0)));
+        if (m_has_influence) influence.push_back(by);
+        return nullptr;
+    }
+
+    // Builds the step index; returns how many steps appear in more than one block
+    long long build_steps() {
+        m_steps.clear();
+        for (size_t i = 0; i < size(); ++i) {
+            if (m_steps.empty() || m_steps.back().run != run[i] || m_steps.back().time != time[i]) {
+                m_steps.push_back({ run[i], time[i], i, 0 });
+            }
+            m_steps.back().count++;
+        }
+        std::vector<std::pair<int32_t, int32_t>> keys;
+        keys.reserve(m_steps.size());
+        for (const Step& s : m_steps) keys.push_back({ s.run, s.time });
+        std::sort(keys.begin(), keys.end());
+        long long split = 0;
+        for (size_t k = 1; k < keys.size(); ++k) {
+            if (keys[k] == keys[k - 1] && (k < 2 || keys[k - 2] != keys[k])) split++;
+        }
+        return split;
+    }
+
+    template <typename T>
+    static void write_column(BlockWriter& out, const std::vector<T>& column) {
+        out.write(column.data(), column.size() * sizeof(T));
+    }
+
+    template <typename T>
+    static void read_column(std::ifstream& in, std::vector<T>& column) {
+        in.read(reinterpret_cast<char*>(column.data()), static_cast<std::streamsize>(column.size() * sizeof(T)));
+    }
+};
@@ -3,27 +3,37 @@
 #include <cmath>
 #include <functional>
 #include <stdexcept>
+#include <atomic>
 #include "Individual.h"
+#include "LinearConstraints.h"
 
 // 2. The Concrete Implementation for the "Welded Beam Design" Problem
 // Reference: Section 4.2 of the paper
 struct WeldedBeamDesign {
 
-    mutable int evaluations = 0;
+    // Atomic so that parallel evaluation can share one problem instance
+    mutable std::atomic<int> evaluations{ 0 };
 
     void reset_evaluations() const {
         evaluations = 0;
     }
 
+    // Load, length and stress limits (the paper's values by default; other
+    // values give the instances of a parameter sweep)
+    double P = 6000.0;
+    double L = 14.0;
+    double tau_max = 13600.0;
+    double sigma_max = 30000.0;
+
     // Constants
-    const double P = 6000.0;
-    const double L = 14.0;
     const double E = 30.0e6;
     const double G = 12.0e6;
-    const double tau_max = 13600.0;
-    const double sigma_max = 30000.0;
     const double delta_max = 0.25;
 
+    WeldedBeamDesign() = default;
+    WeldedBeamDesign(double load, double length, double shear_limit, double bending_limit)
+        : P(load), L(length), tau_max(shear_limit), sigma_max(bending_limit) {}
+
     double get_objective(const Individual& ind) const {
         evaluations++;
         double x1 = ind.variables[0]; // h
@@ -31,25 +41,45 @@ struct WeldedBeamDesign {
         double x3 = ind.variables[2]; // t
         double x4 = ind.variables[3]; // b
 
-        return 1.10471 * std::pow(x1, 2) * x2 + 0.04811 * x3 * x4 * (14.0 + x2);
+        return 1.10471 * std::pow(x1, 2) * x2 + 0.04811 * x3 * x4 * (L + x2);
+    }
+
+    // g3 (h <= b) and g5 (h >= 0.125) are linear and need no simulation, so
+    // candidates can be repaired against them before evaluation
+    LinearConstraints linear_constraints() const {
+        LinearConstraints c;
+        c.add({ 1.0, 0.0, 0.0, -1.0 }, 0.0);    // g3: x1 - x4 <= 0
+        c.add({ -1.0, 0.0, 0.0, 0.0 }, -0.125); // g5: 0.125 - x1 <= 0
+        return c;
     }
 
     // Returns VIOLATION magnitude (Must be >= 0)
     std::vector<double> get_constraints_violation(const Individual& ind) const {
-        const auto raw = get_constraints_raw_values(ind);
         std::vector<double> violations;
+        get_constraints_violation(ind, violations);
+        return violations;
+    }
+
+    // Same, written into 'violations' (reuses its storage)
+    void get_constraints_violation(const Individual& ind, std::vector<double>& violations) const {
+        get_constraints_raw_values(ind, violations);
 
         // In this problem, g(x) <= 0 is satisfied.
         // If g(x) > 0, it is a violation.
-        for (double val : raw) {
-            violations.push_back((val <= 0.0) ? 0.0 : val);
+        for (double& val : violations) {
+            val = (val <= 0.0) ? 0.0 : val;
         }
-        return violations;
     }
 
     // Returns raw g(x) values exactly as defined in Paper Eq (11)-(17).
     // Feasible <= 0.
     std::vector<double> get_constraints_raw_values(const Individual& ind) const {
+        std::vector<double> raw;
+        get_constraints_raw_values(ind, raw);
+        return raw;
+    }
+
+    void get_constraints_raw_values(const Individual& ind, std::vector<double>& raw) const {
         if (ind.variables.size() < 4) {
             throw std::runtime_error("WeldedBeamDesign expects 4 variables");
         }
@@ -83,7 +113,7 @@ struct WeldedBeamDesign {
         double g3 = x1 - x4;
 
         // 4. Cost Constraint: 0.10471*x1^2 + ... - 5.0 <= 0
-        double g4 = 0.10471 * std::pow(x1, 2) + 0.04811 * x3 * x4 * (14.0 + x2) - 5.0;
+        double g4 = 0.10471 * std::pow(x1, 2) + 0.04811 * x3 * x4 * (L + x2) - 5.0;
 
         // 5. Geometry: 0.125 - x1 <= 0
         double g5 = 0.125 - x1;
@@ -94,6 +124,6 @@ struct WeldedBeamDesign {
         // 7. Buckling: P - Pc(x) <= 0
         double g7 = P - Pc;
 
-        return { g1, g2, g3, g4, g5, g6, g7 };
+        raw.assign({ g1, g2, g3, g4, g5, g6, g7 });
     }
 };
\ No newline at end of file
@@ -0,0 +1,2568 @@
+#include "Benchmarks.h"
+#include "BlockWriter.h"
+#include "Civilization.h"
+#include "CivilizationPool.h"
+#include "ContinuationSweep.h"
+#include "EvaluationCoalescer.h"
+#include "EvaluationRecording.h"
+#include "HttpEvaluator.h"
+#include "InfluenceTree.h"
+#include "LicensePool.h"
+#include "Koziel_and_Michalewicz.h"
+#include "LshIndex.h"
+#include "Portfolio.h"
+#include "TaskRuntime.h"
+#include "TrajectoryAnalytics.h"
+#include "TrajectoryLog.h"
+#include "WeldedBeamDesign.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iterator>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// -------------------------------
+// Shared helpers
+// -------------------------------
+using BenchClock = std::chrono::steady_clock;
+
+static double seconds_since(BenchClock::time_point start) {
+    return std::chrono::duration<double>(BenchClock::now() - start).count();
+}
+
+// Threads currently alive in this process (-1 where not available)
+static int process_thread_count() {
+#ifdef __linux__
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("Threads:", 0) == 0) return std::stoi(line.substr(8));
+    }
+#endif
+    return -1;
+}
+
+// A memory figure of this process in kB, e.g. "RssAnon:" (-1 where not available)
+static long long process_memory_kb(const std::string& field) {
+#ifdef __linux__
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind(field, 0) == 0) return std::stoll(line.substr(field.size()));
+    }
+#endif
+    (void)field;
+    return -1;
+}
+
+// Busy-waits for roughly 'micros' to stand in for an expensive simulator
+static double burn_cpu(int micros, double seed) {
+    const auto until = BenchClock::now() + std::chrono::microseconds(micros);
+    double acc = seed;
+    while (BenchClock::now() < until) {
+        for (int k = 0; k < 64; ++k) acc = std::sin(acc) + 1.0;
+    }
+    return acc;
+}
+
+// The Civilization time loop used by the benchmarks (Steps 2-8 per time step)
+static void run_time_steps(Civilization& civ, int max_t) {
+    for (int t = 0; t < max_t; ++t) {
+        civ.cluster_population();
+        civ.identify_leaders();
+        civ.move_society_members();
+        civ.form_global_society();
+        civ.identify_super_leaders();
+        civ.move_global_leaders();
+    }
+    civ.evaluate_population();
+}
+
+// A shipped test problem packaged for the benchmarks
+struct BenchProblem {
+    std::string name;
+    int n = 0;
+    int m = 0;
+    int max_t = 0;
+    std::vector<double> lb, ub;
+    Civilization::ObjFunc objective;
+    Civilization::ConFunc constraints;
+    double target = 0.0; // objective a run must reach (feasibly) to count as solved
+};
+
+static const TwoVariableDesign two_variable_problem;
+static const WeldedBeamDesign welded_beam_problem;
+
+// Section 4.1; known optimum -6961.81
+static BenchProblem bench_problem4_1() {
+    BenchProblem p;
+    p.name = "problem4_1";
+    p.n = 2; p.m = 100; p.max_t = 100;
+    p.lb = { 13.0, 0.0 };
+    p.ub = { 100.0, 100.0 };
+    p.objective = [](const Individual& ind) { return two_variable_problem.get_objective(ind); };
+    p.constraints = [](const Individual& ind) { return two_variable_problem.get_constraints_violation(ind); };
+    p.target = -6800.0;
+    return p;
+}
+
+// Section 4.2; paper best 2.4426
+static BenchProblem bench_problem4_2() {
+    BenchProblem p;
+    p.name = "problem4_2";
+    p.n = 4; p.m = 100; p.max_t = 100;
+    p.lb = { 0.1, 0.1, 0.1, 0.1 };
+    p.ub = { 2.0, 10.0, 10.0, 2.0 };
+    p.objective = [](const Individual& ind) { return welded_beam_problem.get_objective(ind); };
+    p.constraints = [](const Individual& ind) { return welded_beam_problem.get_constraints_violation(ind); };
+    p.target = 2.6;
+    return p;
+}
+
+// Lowest objective among feasible individuals (+inf if none is feasible)
+static double best_feasible_objective(const std::vector<Individual>& population) {
+    double best = std::numeric_limits<double>::infinity();
+    for (const auto& ind : population) {
+        if (Civilization::is_feasible(ind)) best = std::min(best, ind.objective_value);
+    }
+    return best;
+}
+
+// Outcome of one run measured against the problem's target
+struct TargetOutcome {
+    bool reached = false;
+    long long evals_to_target = -1;
+    long long evals_to_feasible = -1; // first strictly feasible individual
+    long long total_evals = 0;
+    double final_best = std::numeric_limits<double>::infinity();
+};
+
+// Runs the time loop, checking after every population evaluation whether the
+// best feasible objective has reached the target; with max_evals > 0 the
+// loop also ends once that many evaluations are spent
+static TargetOutcome run_to_target(Civilization& civ, int max_t, double target, long long max_evals = 0) {
+    TargetOutcome out;
+    auto check = [&]() {
+        double best = best_feasible_objective(civ.get_population());
+        out.final_best = std::min(out.final_best, best);
+        if (out.evals_to_feasible < 0 && std::isfinite(best)) out.evals_to_feasible = civ.evaluations();
+        if (!out.reached && best <= target) {
+            out.reached = true;
+            out.evals_to_target = civ.evaluations();
+        }
+    };
+
+    for (int t = 0; t < max_t; ++t) {
+        if (max_evals > 0 && civ.evaluations() >= max_evals) break;
+        civ.cluster_population();
+        civ.identify_leaders();
+        check();
+        civ.move_society_members();
+        civ.form_global_society();
+        civ.identify_super_leaders();
+        civ.move_global_leaders();
+    }
+    civ.evaluate_population();
+    check();
+    out.total_evals = civ.evaluations();
+    return out;
+}
+
+// Prints one summary row over the outcomes of several seeds
+static void print_target_row(const std::string& label, const std::vector<TargetOutcome>& outcomes) {
+    const int num_runs = static_cast<int>(outcomes.size());
+    int reached = 0, feasible = 0, timed_feasible = 0;
+    double sum_evals = 0.0, sum_best = 0.0, sum_feasible_evals = 0.0;
+    std::vector<long long> hits;
+    for (const auto& o : outcomes) {
+        if (std::isfinite(o.final_best)) {
+            feasible++;
+            sum_best += o.final_best;
+        }
+        if (o.evals_to_feasible >= 0) {
+            timed_feasible++;
+            sum_feasible_evals += static_cast<double>(o.evals_to_feasible);
+        }
+        if (o.reached) {
+            reached++;
+            sum_evals += static_cast<double>(o.evals_to_target);
+            hits.push_back(o.evals_to_target);
+        }
+    }
+    std::sort(hits.begin(), hits.end());
+
+    // Columns without a single qualifying run print n/a rather than 0
+    auto cell = [](bool any, double value, int width, int precision) {
+        std::ostringstream text;
+        if (any) text << std::fixed << std::setprecision(precision) << value;
+        else text << "n/a";
+        std::ostringstream out;
+        out << std::setw(width) << text.str();
+        return out.str();
+    };
+    std::cout << std::left << std::setw(28) << label << std::right
+        << std::setw(8) << reached << "/" << num_runs
+        << cell(reached > 0, reached ? sum_evals / reached : 0.0, 14, 0)
+        << cell(!hits.empty(), hits.empty() ? 0.0 : static_cast<double>(hits[hits.size() / 2]), 12, 0)
+        << cell(feasible > 0, feasible ? sum_best / feasible : 0.0, 16, 4)
+        << cell(timed_feasible > 0, timed_feasible ? sum_feasible_evals / timed_feasible : 0.0, 16, 0) << "\n";
+}
+
+// Runs 'num_runs' seeds of one configuration and prints one summary row
+static void report_target_study(const BenchProblem& problem, const std::string& label,
+    const std::function<void(Civilization&)>& configure, int num_runs, unsigned base_seed, long long max_evals = 0) {
+    std::vector<TargetOutcome> outcomes(static_cast<size_t>(num_runs));
+    TaskRuntime::instance().parallel_for(0, num_runs, [&](int run) {
+        Civilization civ(problem.m, problem.n, problem.lb, problem.ub,
+            problem.objective, problem.constraints, base_seed + static_cast<unsigned>(run));
+        civ.set_verbose(false);
+        configure(civ);
+        civ.initialize();
+        outcomes[run] = run_to_target(civ, problem.max_t, problem.target, max_evals);
+    });
+    print_target_row(label, outcomes);
+}
+
+static void print_target_header(const BenchProblem& problem) {
+    std::cout << "\n" << problem.name << " (m=" << problem.m << ", T=" << problem.max_t
+        << ", target <= " << std::defaultfloat << std::setprecision(6) << problem.target << ")\n";
+    std::cout << std::left << std::setw(28) << "configuration" << std::right
+        << std::setw(11) << "solved" << std::setw(14) << "mean evals" << std::setw(12) << "median"
+        << std::setw(16) << "mean best" << std::setw(16) << "first feasible" << "\n";
+}
+
+// -------------------------------
+// Nested parallelism (runs x societies x evaluations)
+// -------------------------------
+int bench_nested_parallelism() {
+    TaskRuntime& runtime = TaskRuntime::instance();
+    const unsigned cap = runtime.max_threads();
+
+    const int NUM_RUNS = static_cast<int>(std::max(4u, 2 * cap));
+    const int m = 100;
+    const int n = 4;
+    const int MAX_T = 20;
+    const int EVAL_COST_US = 20;
+
+    const std::vector<double> lb = { 0.1, 0.1, 0.1, 0.1 };
+    const std::vector<double> ub = { 2.0, 10.0, 10.0, 2.0 };
+
+    WeldedBeamDesign problem;
+    std::atomic<int> peak_threads{ process_thread_count() };
+    std::atomic<int> peak_societies{ 0 };
+
+    auto objective = [&](const Individual& ind) {
+        burn_cpu(EVAL_COST_US, ind.variables[0]);
+        return problem.get_objective(ind);
+    };
+    auto constraints = [&](const Individual& ind) {
+        return problem.get_constraints_violation(ind);
+    };
+
+    auto run_study = [&](bool parallel, std::vector<double>& best_objectives) {
+        best_objectives.assign(static_cast<size_t>(NUM_RUNS), 0.0);
+        auto one_run = [&](int run) {
+            Civilization civ(m, n, lb, ub, objective, constraints, 1000u + static_cast<unsigned>(run));
+            civ.set_verbose(false);
+            civ.set_parallel_societies(parallel);
+            civ.set_parallel_evaluation(parallel);
+            civ.initialize();
+            run_time_steps(civ, MAX_T);
+            best_objectives[run] = civ.get_best_solution().objective_value;
+
+            int threads = process_thread_count();
+            int seen = peak_threads.load();
+            while (threads > seen && !peak_threads.compare_exchange_weak(seen, threads)) {}
+        };
+
+        if (parallel) runtime.parallel_for(0, NUM_RUNS, one_run);
+        else for (int run = 0; run < NUM_RUNS; ++run) one_run(run);
+    };
+
+    std::cout << "\n============================================================\n";
+    std::cout << "Nested parallelism benchmark (runs x societies x evaluations)\n";
+    std::cout << "runs=" << NUM_RUNS << ", m=" << m << ", T=" << MAX_T
+        << ", synthetic evaluation cost=" << EVAL_COST_US << "us\n";
+    std::cout << "============================================================\n";
+
+    std::vector<double> serial_best, parallel_best;
+
+    auto start = BenchClock::now();
+    run_study(false, serial_best);
+    const double serial_s = seconds_since(start);
+
+    runtime.reset_stats();
+    start = BenchClock::now();
+    run_study(true, parallel_best);
+    const double parallel_s = seconds_since(start);
+
+    const TaskRuntime::Stats stats = runtime.stats();
+    const bool identical = (serial_best == parallel_best);
+    const bool within_cap = stats.peak_active <= static_cast<int>(stats.max_threads);
+
+    // What one thread per parallel item at every level would have spawned
+    const long long naive_threads = static_cast<long long>(NUM_RUNS) * m;
+
+    std::cout << "Hardware threads:          " << std::thread::hardware_concurrency() << "\n";
+    std::cout << "Runtime thread cap:        " << stats.max_threads << "\n";
+    std::cout << "Worker threads created:    " << stats.worker_threads << " (+1 calling thread)\n";
+    std::cout << "Peak concurrent tasks:     " << stats.peak_active << (within_cap ? " (within cap)" : " (EXCEEDS cap)") << "\n";
+    std::cout << "Peak process threads:      ";
+    if (peak_threads.load() >= 0) std::cout << peak_threads.load() << "\n";
+    else std::cout << "n/a\n";
+    std::cout << "Naive nesting would spawn: ~" << naive_threads << " threads (runs x evaluations)\n";
+    std::cout << "Tasks executed / stolen:   " << stats.tasks_executed << " / " << stats.tasks_stolen << "\n";
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Serial wall time:          " << serial_s << " s\n";
+    std::cout << "Parallel wall time:        " << parallel_s << " s (speed-up "
+        << std::setprecision(2) << (parallel_s > 0.0 ? serial_s / parallel_s : 0.0) << "x)\n";
+    std::cout << "Results identical to serial: " << (identical ? "yes" : "NO") << "\n";
+
+    return (within_cap && identical) ? 0 : 1;
+}
+
+// -------------------------------
+// Self-adaptive operator probabilities vs the fixed 25/50/25 split
+// -------------------------------
+int bench_adaptive_operators() {
+    const int NUM_RUNS = 30;
+    std::cout << "\n============================================================\n";
+    std::cout << "Evaluations to target: fixed vs self-adaptive region probabilities\n";
+    std::cout << "(" << NUM_RUNS << " seeds per configuration; evals over solved runs, best over feasible runs)\n";
+    std::cout << "============================================================\n";
+
+    for (const BenchProblem& problem : { bench_problem4_1(), bench_problem4_2() }) {
+        print_target_header(problem);
+        report_target_study(problem, "fixed 25/50/25",
+            [](Civilization&) {}, NUM_RUNS, 500);
+        report_target_study(problem, "adaptive (pmin=0.10)",
+            [](Civilization& civ) { civ.set_adaptive_operators(true, 0.10); }, NUM_RUNS, 500);
+        report_target_study(problem, "adaptive (pmin=0.05)",
+            [](Civilization& civ) { civ.set_adaptive_operators(true, 0.05); }, NUM_RUNS, 500);
+    }
+    return 0;
+}
+
+// -------------------------------
+// Epsilon-constrained feasibility schedule
+// -------------------------------
+int bench_epsilon_schedule() {
+    const int NUM_RUNS = 30;
+    std::cout << "\n============================================================\n";
+    std::cout << "Evaluations to first feasible: strict dominance vs epsilon schedule\n";
+    std::cout << "(" << NUM_RUNS << " seeds per configuration; 'first feasible' = mean evaluations\n";
+    std::cout << " until the population holds a strictly feasible individual)\n";
+    std::cout << "============================================================\n";
+
+    for (const BenchProblem& problem : { bench_problem4_1(), bench_problem4_2() }) {
+        const int half = problem.max_t / 2;
+        const int fifth = problem.max_t / 5;
+        print_target_header(problem);
+        report_target_study(problem, "strict (epsilon = 0)",
+            [](Civilization&) {}, NUM_RUNS, 700);
+        report_target_study(problem, "epsilon, Tc=T/2, cp=2",
+            [half](Civilization& civ) { civ.set_epsilon_schedule(true, half, -1.0, 2.0); }, NUM_RUNS, 700);
+        report_target_study(problem, "epsilon, Tc=T/2, cp=5",
+            [half](Civilization& civ) { civ.set_epsilon_schedule(true, half, -1.0, 5.0); }, NUM_RUNS, 700);
+        report_target_study(problem, "epsilon, Tc=T/5, cp=2",
+            [fifth](Civilization& civ) { civ.set_epsilon_schedule(true, fifth, -1.0, 2.0); }, NUM_RUNS, 700);
+    }
+    return 0;
+}
+
+// -------------------------------
+// Algorithm portfolio vs its individual configurations
+// -------------------------------
+int bench_portfolio() {
+    const int NUM_RUNS = 20;
+    const long long BUDGET = 20000; // evaluations per run, shared by all members
+
+    std::cout << "\n============================================================\n";
+    std::cout << "Portfolio vs single configurations (" << BUDGET << " evaluations per run, "
+        << NUM_RUNS << " seeds)\n";
+    std::cout << "Portfolio evaluations-to-target and to-feasible are counted at epoch granularity.\n";
+    std::cout << "Every member evaluates in parallel, so reallocated shares move runtime workers too.\n";
+    std::cout << "============================================================\n";
+
+    // Core reallocation only shows when members evaluate in parallel: the
+    // member with the larger share keeps its evaluation tasks queued for longer
+    auto parallel = [](Civilization& civ) { civ.set_parallel_evaluation(true); };
+    const std::vector<Portfolio::Config> configs = {
+        { "m=50", 50, parallel },
+        { "m=100", 100, parallel },
+        { "m=200", 200, parallel },
+        { "m=100 adaptive", 100, [parallel](Civilization& civ) { parallel(civ); civ.set_adaptive_operators(true); } },
+    };
+
+    for (const BenchProblem& base : { bench_problem4_1(), bench_problem4_2() }) {
+        BenchProblem header = base;
+        header.max_t = static_cast<int>(BUDGET / base.m);
+        print_target_header(header);
+
+        for (const auto& config : configs) {
+            BenchProblem problem = base;
+            problem.m = config.pop_size;
+            problem.max_t = static_cast<int>(BUDGET / config.pop_size);
+            report_target_study(problem, "alone: " + config.label,
+                [&](Civilization& civ) { if (config.configure) config.configure(civ); }, NUM_RUNS, 900);
+        }
+
+        for (bool share_elites : { false, true }) {
+            std::vector<TargetOutcome> outcomes(static_cast<size_t>(NUM_RUNS));
+            std::vector<std::vector<double>> final_shares(static_cast<size_t>(NUM_RUNS));
+            TaskRuntime::instance().parallel_for(0, NUM_RUNS, [&](int run) {
+                Portfolio portfolio(base.n, base.lb, base.ub, base.objective, base.constraints,
+                    configs, 900u + static_cast<unsigned>(run));
+                portfolio.set_share_elites(share_elites);
+                portfolio.set_target(base.target);
+                Portfolio::Result r = portfolio.run(BUDGET);
+
+                TargetOutcome& o = outcomes[run];
+                o.reached = r.evals_to_target >= 0;
+                o.evals_to_target = r.evals_to_target;
+                o.total_evals = r.evaluations;
+                if (r.best_member >= 0 && Civilization::is_feasible(r.best)) {
+                    o.final_best = r.best.objective_value;
+                }
+                o.evals_to_feasible = r.evals_to_feasible;
+                for (const auto& member : r.members) final_shares[run].push_back(member.final_share);
+            });
+            print_target_row(share_elites ? "portfolio + elite sharing" : "portfolio", outcomes);
+
+            std::cout << "    mean final shares:";
+            for (size_t c = 0; c < configs.size(); ++c) {
+                double sum = 0.0;
+                for (const auto& shares : final_shares) sum += shares[c];
+                std::cout << " " << configs[c].label << "=" << std::setprecision(2) << sum / NUM_RUNS;
+            }
+            std::cout << "\n";
+        }
+    }
+    return 0;
+}
+
+// -------------------------------
+// Cost-aware (longest-predicted-first) evaluation scheduling
+// -------------------------------
+
+// Makespan of list scheduling 'costs' in 'order' on 'workers' identical workers
+static double simulate_makespan(const std::vector<double>& costs, const std::vector<int>& order, int workers) {
+    std::priority_queue<double, std::vector<double>, std::greater<double>> finish;
+    for (int w = 0; w < workers; ++w) finish.push(0.0);
+    double makespan = 0.0;
+    for (int i : order) {
+        double t = finish.top() + costs[i];
+        finish.pop();
+        finish.push(t);
+        makespan = std::max(makespan, t);
+    }
+    return makespan;
+}
+
+int bench_cost_scheduling() {
+    const int WORKER_COUNTS[] = { 8, 32, 64 };
+    const int m = 100;
+    const int MAX_T = 30;
+    const std::vector<double> lb = { 0.1, 0.1, 0.1, 0.1 };
+    const std::vector<double> ub = { 2.0, 10.0, 10.0, 2.0 };
+
+    // Welded beam whose cost grows with x2 (think mesh size), 20us .. 420us
+    WeldedBeamDesign problem;
+    auto objective = [&](const Individual& ind) {
+        const double frac = (ind.variables[1] - lb[1]) / (ub[1] - lb[1]);
+        burn_cpu(20 + static_cast<int>(400.0 * frac), ind.variables[0]);
+        return problem.get_objective(ind);
+    };
+    auto constraints = [&](const Individual& ind) { return problem.get_constraints_violation(ind); };
+
+    std::cout << "\n============================================================\n";
+    std::cout << "Cost-aware evaluation scheduling (welded beam, cost ~ x2)\n";
+    std::cout << "m=" << m << ", T=" << MAX_T << "; per-batch makespans are simulated by list\n";
+    std::cout << "scheduling the measured costs, natural order vs longest-predicted-first\n";
+    std::cout << "============================================================\n";
+    std::cout << std::left << std::setw(20) << "predictor" << std::right
+        << std::setw(10) << "MAPE" << std::setw(8) << "corr" << std::setw(9) << "workers"
+        << std::setw(15) << "natural (ms)" << std::setw(11) << "LPT (ms)"
+        << std::setw(15) << "lower bd (ms)" << std::setw(9) << "saving" << "\n";
+
+    const std::pair<const char*, EvaluationCostModel::Kind> models[] = {
+        { "nearest neighbour", EvaluationCostModel::NEAREST_NEIGHBOUR },
+        { "linear", EvaluationCostModel::LINEAR },
+    };
+
+    std::vector<int> natural(m);
+    for (int i = 0; i < m; ++i) natural[i] = i;
+
+    for (const auto& model : models) {
+        Civilization civ(m, 4, lb, ub, objective, constraints, 4242);
+        civ.set_verbose(false);
+        civ.set_cost_aware_scheduling(model.second);
+        civ.set_parallel_evaluation(true);
+        civ.initialize();
+
+        std::vector<std::vector<double>> costs;
+        std::vector<std::vector<int>> orders;
+        double abs_pct_err = 0.0;
+        double sx = 0, sy = 0, sxx = 0, syy = 0, sxy = 0;
+        double np = 0.0;
+
+        for (int t = 0; t < MAX_T; ++t) {
+            civ.step();
+            // The first batch has no history to predict from
+            if (t == 0) continue;
+
+            const auto& cost = civ.last_evaluation_seconds();
+            const auto& pred = civ.last_predicted_seconds();
+            costs.push_back(cost);
+            orders.push_back(civ.last_dispatch_order());
+            for (int i = 0; i < m; ++i) {
+                abs_pct_err += std::abs(pred[i] - cost[i]) / cost[i];
+                np += 1.0;
+                sx += pred[i]; sy += cost[i];
+                sxx += pred[i] * pred[i]; syy += cost[i] * cost[i]; sxy += pred[i] * cost[i];
+            }
+        }
+
+        const double cov = sxy / np - (sx / np) * (sy / np);
+        const double var_x = sxx / np - (sx / np) * (sx / np);
+        const double var_y = syy / np - (sy / np) * (sy / np);
+        const double corr = (var_x > 0 && var_y > 0) ? cov / std::sqrt(var_x * var_y) : 0.0;
+        const double batches = static_cast<double>(costs.size());
+
+        for (int workers : WORKER_COUNTS) {
+            double natural_total = 0.0, lpt_total = 0.0, bound_total = 0.0;
+            for (size_t b = 0; b < costs.size(); ++b) {
+                natural_total += simulate_makespan(costs[b], natural, workers);
+                lpt_total += simulate_makespan(costs[b], orders[b], workers);
+                double sum = 0.0, longest = 0.0;
+                for (double c : costs[b]) { sum += c; longest = std::max(longest, c); }
+                bound_total += std::max(sum / workers, longest);
+            }
+
+            std::cout << std::left << std::setw(20) << model.first << std::right << std::fixed
+                << std::setw(9) << std::setprecision(1) << 100.0 * abs_pct_err / np << "%"
+                << std::setw(8) << std::setprecision(2) << corr
+                << std::setw(9) << workers
+                << std::setw(15) << std::setprecision(3) << 1e3 * natural_total / batches
+                << std::setw(11) << 1e3 * lpt_total / batches
+                << std::setw(15) << 1e3 * bound_total / batches
+                << std::setw(8) << std::setprecision(1) << 100.0 * (1.0 - lpt_total / natural_total) << "%\n";
+        }
+    }
+    return 0;
+}
+
+// -------------------------------
+// LSH nearest-leader search vs brute force
+// -------------------------------
+int bench_lsh_nearest() {
+    std::cout << "\n============================================================\n";
+    std::cout << "Approximate nearest-leader search (p-stable LSH, 4 hashes/table)\n";
+    std::cout << "Leaders drawn around 32 centres, queries are perturbed leaders\n";
+    std::cout << "============================================================\n";
+    std::cout << std::right << std::setw(6) << "n" << std::setw(9) << "leaders" << std::setw(8) << "tables"
+        << std::setw(9) << "recall" << std::setw(12) << "dist ratio"
+        << std::setw(14) << "brute (ms)" << std::setw(12) << "LSH (ms)" << std::setw(10) << "speed-up" << "\n";
+
+    const int QUERIES = 500;
+    for (int n : { 200, 2000 }) {
+        for (int num_leaders : { 256, 2048 }) {
+            std::mt19937 gen(static_cast<unsigned>(n * 31 + num_leaders));
+            std::normal_distribution<double> gauss(0.0, 1.0);
+            std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+            std::vector<std::vector<double>> centres(32, std::vector<double>(n));
+            for (auto& c : centres) for (double& v : c) v = 10.0 * unit(gen);
+            std::vector<std::vector<double>> leaders(num_leaders, std::vector<double>(n));
+            for (int l = 0; l < num_leaders; ++l)
+                for (int j = 0; j < n; ++j) leaders[l][j] = centres[l % 32][j] + 0.3 * gauss(gen);
+            std::vector<std::vector<double>> queries(QUERIES, std::vector<double>(n));
+            for (int q = 0; q < QUERIES; ++q) {
+                const auto& base = leaders[static_cast<size_t>(unit(gen) * num_leaders) % num_leaders];
+                for (int j = 0; j < n; ++j) queries[q][j] = base[j] + 0.15 * gauss(gen);
+            }
+
+            auto dist2 = [n](const std::vector<double>& a, const std::vector<double>& b) {
+                double s = 0.0;
+                for (int j = 0; j < n; ++j) { const double d = a[j] - b[j]; s += d * d; }
+                return s;
+            };
+
+            auto start = BenchClock::now();
+            std::vector<int> truth(QUERIES);
+            for (int q = 0; q < QUERIES; ++q) {
+                double best = std::numeric_limits<double>::max();
+                for (int l = 0; l < num_leaders; ++l) {
+                    const double d = dist2(queries[q], leaders[l]);
+                    if (d < best) { best = d; truth[q] = l; }
+                }
+            }
+            const double brute_s = seconds_since(start);
+
+            std::vector<double> sample;
+            for (int k = 0; k < 32; ++k) sample.push_back(std::sqrt(dist2(leaders[k], leaders[(k * 7 + 3) % num_leaders])));
+            std::nth_element(sample.begin(), sample.begin() + 16, sample.end());
+            const double width = 0.5 * sample[16];
+
+            std::vector<const double*> points(num_leaders);
+            for (int l = 0; l < num_leaders; ++l) points[l] = leaders[l].data();
+            LshIndex index(n, 32, 4, 99);
+
+            for (int tables : { 4, 8, 16, 32 }) {
+                start = BenchClock::now();
+                index.build(points, width, tables);
+                long long evals = 0;
+                int hits = 0;
+                for (int q = 0; q < QUERIES; ++q) {
+                    int found = index.query(queries[q].data(), &evals);
+                    if (found < 0) {
+                        // Exact fallback, as the engine does
+                        double best = std::numeric_limits<double>::max();
+                        for (int l = 0; l < num_leaders; ++l) {
+                            const double d = dist2(queries[q], leaders[l]);
+                            if (d < best) { best = d; found = l; }
+                        }
+                        evals += num_leaders;
+                    }
+                    if (dist2(queries[q], leaders[found]) <= dist2(queries[q], leaders[truth[q]])) hits++;
+                }
+                const double lsh_s = seconds_since(start);
+
+                std::cout << std::setw(6) << n << std::setw(9) << num_leaders << std::setw(8) << tables
+                    << std::fixed << std::setw(9) << std::setprecision(3) << static_cast<double>(hits) / QUERIES
+                    << std::setw(12) << std::setprecision(3) << static_cast<double>(evals) / (static_cast<double>(QUERIES) * num_leaders)
+                    << std::setw(14) << std::setprecision(2) << 1e3 * brute_s
+                    << std::setw(12) << 1e3 * lsh_s
+                    << std::setw(9) << std::setprecision(1) << brute_s / lsh_s << "x\n";
+            }
+        }
+    }
+
+    // Engine level: nearest-leader queries of Steps 4 and 7 on a 200-variable
+    // problem. Societies are tiny in 200 dimensions, so most Step 4 queries
+    // stay exact; the super-leader set of Step 7 is large enough for LSH.
+    // Where LSH misses the recall target with all tables in use, the engine
+    // answers exactly ("exact fb"); "LSH recall" is measured on the probes.
+    const int n = 200, m = 300, MAX_T = 10;
+    std::vector<double> lb(n, -5.0), ub(n, 5.0);
+    auto sphere = [](const Individual& ind) {
+        double s = 0.0;
+        for (double v : ind.variables) s += (v - 1.0) * (v - 1.0);
+        return s;
+    };
+    auto no_constraints = [](const Individual&) { return std::vector<double>{ 0.0 }; };
+
+    std::cout << "\nEngine: shifted sphere, n=" << n << ", m=" << m << ", T=" << MAX_T << "\n";
+    std::cout << std::left << std::setw(12) << "search" << std::right << std::setw(10) << "queries"
+        << std::setw(12) << "via LSH" << std::setw(12) << "exact fb" << std::setw(16) << "dist evals"
+        << std::setw(12) << "LSH recall" << std::setw(12) << "move (ms)" << std::setw(12) << "step (ms)" << "\n";
+    for (bool approximate : { false, true }) {
+        Civilization civ(m, n, lb, ub, sphere, no_constraints, 77);
+        civ.set_verbose(false);
+        if (approximate) civ.set_approximate_nearest_search(true, 0.9, 16);
+        civ.initialize();
+        double move_s = 0.0;
+        auto start = BenchClock::now();
+        for (int t = 0; t < MAX_T; ++t) {
+            civ.cluster_population();
+            civ.identify_leaders();
+            auto move_start = BenchClock::now();
+            civ.move_society_members();
+            civ.form_global_society();
+            civ.identify_super_leaders();
+            civ.move_global_leaders();
+            move_s += seconds_since(move_start);
+        }
+        const double step_s = seconds_since(start) / MAX_T;
+        move_s /= MAX_T;
+        const auto& st = civ.nearest_search_stats();
+        std::cout << std::left << std::setw(12) << (approximate ? "LSH" : "exact") << std::right
+            << std::setw(10) << st.queries << std::setw(12) << st.approximate << std::setw(12) << st.exact_fallbacks
+            << std::setw(16) << st.distance_evals << std::fixed << std::setw(12) << std::setprecision(3)
+            << (st.probes ? static_cast<double>(st.probe_hits) / st.probes : 1.0)
+            << std::setw(12) << std::setprecision(2) << 1e3 * move_s
+            << std::setw(12) << 1e3 * step_s << "\n";
+    }
+    return 0;
+}
+
+// -------------------------------
+// Out-of-core population storage
+// -------------------------------
+int bench_population_storage() {
+    std::cout << "\n============================================================\n";
+    std::cout << "Out-of-core population storage and checkpoints\n";
+    std::cout << "============================================================\n";
+
+    // Out of core must run exactly like in memory, and resuming from a
+    // checkpoint must continue the run exactly (in either mode)
+    const BenchProblem p = bench_problem4_2();
+    const std::string storage_path = "population_storage.bin";
+    const std::string resumed_path = "population_resumed.bin";
+    const std::string checkpoint_path = "population_checkpoint.bin";
+    const std::string damaged_path = "population_damaged.bin";
+    const int HALF = 25;
+
+    auto make = [&](unsigned seed) {
+        auto civ = std::make_unique<Civilization>(p.m, p.n, p.lb, p.ub, p.objective, p.constraints, seed);
+        civ->set_verbose(false);
+        return civ;
+    };
+    auto same_run = [&](Civilization& a, Civilization& b) {
+        bool same = a.evaluations() == b.evaluations() && a.time_step() == b.time_step() &&
+            a.get_best_ever().objective_value == b.get_best_ever().objective_value;
+        for (int i = 0; i < p.m && same; ++i) {
+            const Individual x = a.get_individual(i);
+            const Individual y = b.get_individual(i);
+            same = x.variables == y.variables && x.objective_value == y.objective_value &&
+                x.constraint_violations == y.constraint_violations;
+        }
+        return same;
+    };
+
+    auto straight = make(42);
+    straight->initialize();
+    for (int t = 0; t < 2 * HALF; ++t) straight->step();
+
+    auto out_of_core = make(42);
+    out_of_core->set_population_storage(storage_path);
+    out_of_core->set_checkpoint(checkpoint_path, HALF);
+    out_of_core->initialize();
+    for (int t = 0; t < HALF; ++t) out_of_core->step();
+    out_of_core->set_checkpoint("");
+    for (int t = 0; t < HALF; ++t) out_of_core->step();
+
+    auto resumed = make(1);
+    resumed->set_population_storage(resumed_path);
+    resumed->restore_checkpoint(checkpoint_path);
+    for (int t = 0; t < HALF; ++t) resumed->step();
+
+    auto resumed_in_memory = make(1);
+    resumed_in_memory->restore_checkpoint(checkpoint_path);
+    for (int t = 0; t < HALF; ++t) resumed_in_memory->step();
+
+    bool ok = true;
+    auto report = [&](const std::string& what, bool passed) {
+        std::cout << std::left << std::setw(52) << (p.name + ": " + what) << std::right << " -> "
+            << (passed ? "identical" : "DIFFERENT") << "\n";
+        ok = ok && passed;
+    };
+    report(std::to_string(2 * HALF) + " steps out of core vs in memory", same_run(*straight, *out_of_core));
+    report("restore out of core + " + std::to_string(HALF) + " steps", same_run(*straight, *resumed));
+    report("restore in memory + " + std::to_string(HALF) + " steps", same_run(*straight, *resumed_in_memory));
+
+    // A damaged checkpoint must be rejected before anything is read from it
+    std::string bytes;
+    {
+        std::ifstream in(checkpoint_path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    auto rejected = [&](const std::string& what, const std::string& damaged) {
+        {
+            std::ofstream out(damaged_path, std::ios::binary | std::ios::trunc);
+            out.write(damaged.data(), damaged.size());
+        }
+        bool threw = false;
+        try {
+            make(1)->restore_checkpoint(damaged_path);
+        }
+        catch (const std::runtime_error&) {
+            threw = true;
+        }
+        std::cout << std::left << std::setw(52) << ("checkpoint " + what) << std::right << " -> "
+            << (threw ? "rejected" : "ACCEPTED") << "\n";
+        ok = ok && threw;
+    };
+    MappedPopulation::Header header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    auto with_header = [&](const MappedPopulation::Header& h) {
+        std::string damaged = bytes;
+        std::memcpy(&damaged[0], &h, sizeof(h));
+        return damaged;
+    };
+    rejected("truncated to half", bytes.substr(0, bytes.size() / 2));
+    rejected("truncated to its header", bytes.substr(0, sizeof(header)));
+    MappedPopulation::Header h = header;
+    h.size = h.capacity + 1;
+    rejected("with size > capacity", with_header(h));
+    h = header;
+    h.offsets[2] += MappedPopulation::PAGE;
+    rejected("with a column offset moved", with_header(h));
+    h = header;
+    h.num_constraints = MappedPopulation::MAX_WIDTH;
+    rejected("with a huge constraint count", with_header(h));
+
+    out_of_core.reset();
+    resumed.reset();
+    for (const std::string& path : { storage_path, resumed_path, checkpoint_path, damaged_path }) std::remove(path.c_str());
+
+    // Resident memory and pass times for a large population, in memory and
+    // out of core. Out of core the population is file-backed (RssFile, and
+    // only the rows of the current window); in memory it is anonymous heap.
+    const int m = 1000000, n = 50;
+    std::vector<double> lb(n, -5.0), ub(n, 5.0);
+    auto sphere = [](const Individual& ind) {
+        double s = 0.0;
+        for (double v : ind.variables) s += v * v;
+        return s;
+    };
+    auto one_constraint = [](const Individual& ind) { return std::vector<double>{ std::max(0.0, ind.variables[0]) }; };
+    auto mb = [](long long kb) {
+        std::ostringstream text;
+        if (kb < 0) text << "n/a";
+        else text << std::fixed << std::setprecision(1) << kb / 1024.0;
+        return text.str();
+    };
+
+    std::cout << "\n" << m << " agents, n = " << n << "\n";
+    std::cout << std::setw(12) << "mode" << std::setw(14) << "RssAnon (MB)" << std::setw(14) << "RssFile (MB)"
+        << std::setw(10) << "init (s)" << std::setw(10) << "eval (s)" << std::setw(16) << "checkpoint (s)"
+        << std::setw(13) << "restore (s)" << "\n";
+    // Out of core first, so that heap freed by the in-memory run does not count against it
+    for (bool in_file : { true, false }) {
+        const long long anon0 = process_memory_kb("RssAnon:");
+        const long long file0 = process_memory_kb("RssFile:");
+        Civilization civ(m, n, lb, ub, sphere, one_constraint, 5);
+        civ.set_verbose(false);
+        if (in_file) civ.set_population_storage(storage_path);
+
+        auto start = BenchClock::now();
+        civ.initialize();
+        const double init_s = seconds_since(start);
+        start = BenchClock::now();
+        civ.evaluate_population();
+        const double eval_s = seconds_since(start);
+        const long long anon = process_memory_kb("RssAnon:");
+        const long long file = process_memory_kb("RssFile:");
+
+        start = BenchClock::now();
+        civ.save_checkpoint(checkpoint_path);
+        const double checkpoint_s = seconds_since(start);
+
+        Civilization restored(1, n, lb, ub, sphere, one_constraint, 5);
+        if (in_file) restored.set_population_storage(resumed_path);
+        start = BenchClock::now();
+        restored.restore_checkpoint(checkpoint_path);
+        const double restore_s = seconds_since(start);
+
+        std::cout << std::setw(12) << (in_file ? "out of core" : "in memory")
+            << std::setw(14) << mb(anon < 0 ? -1 : anon - anon0) << std::setw(14) << mb(file < 0 ? -1 : file - file0)
+            << std::fixed << std::setprecision(2) << std::setw(10) << init_s << std::setw(10) << eval_s
+            << std::setw(16) << checkpoint_s << std::setw(13) << restore_s << "\n";
+    }
+    for (const std::string& path : { storage_path, resumed_path, checkpoint_path }) std::remove(path.c_str());
+    std::cout << std::defaultfloat << std::setprecision(6);
+    return ok ? 0 : 1;
+}
+
+// -------------------------------
+// HTTP evaluation service
+// -------------------------------
+
+// Local stand-in for a remote evaluation service: HTTP/1.1 on 127.0.0.1,
+// one thread per connection, keep-alive and pipelining, binary or JSON by
+// request Content-Type. Every request waits 'latency_us' (network and
+// service overhead); every 'fail_every'-th request gets a 503 and the
+// connection is closed, to exercise client retries.
+class StandInEvaluationServer {
+public:
+    StandInEvaluationServer(int num_vars, Civilization::ObjFunc obj, Civilization::ConFunc con,
+        int latency_us, int fail_every = 0)
+        : n(num_vars), objective(std::move(obj)), constraints(std::move(con)),
+        m_latency_us(latency_us), m_fail_every(fail_every) {
+        http_wire::startup();
+        listener = ::socket(AF_INET, SOCK_STREAM, 0);
+        int one = 1;
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&one), sizeof(one));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0; // any free port
+        socklen_t length = sizeof(addr);
+        if (::bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(listener, 64) != 0 ||
+            getsockname(listener, reinterpret_cast<sockaddr*>(&addr), &length) != 0) {
+            throw std::runtime_error("StandInEvaluationServer: cannot listen on 127.0.0.1");
+        }
+        m_port = ntohs(addr.sin_port);
+        acceptor = std::thread([this]() { accept_loop(); });
+    }
+
+    ~StandInEvaluationServer() {
+        stopping = true;
+        shutdown_socket(listener);
+        http_wire::close_socket(listener);
+        acceptor.join();
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto s : open_sockets) shutdown_socket(s);
+        for (auto& t : handlers) t.join();
+    }
+
+    int port() const { return m_port; }
+    long long requests() const { return m_requests.load(); }
+
+private:
+    int n;
+    Civilization::ObjFunc objective;
+    Civilization::ConFunc constraints;
+    int m_latency_us;
+    int m_fail_every;
+    int m_port = 0;
+    http_wire::socket_t listener;
+    std::thread acceptor;
+    std::atomic<bool> stopping{ false };
+    std::atomic<long long> m_requests{ 0 };
+    std::mutex mutex;
+    std::vector<std::thread> handlers;
+    std::vector<http_wire::socket_t> open_sockets;
+
+    static void shutdown_socket(http_wire::socket_t s) {
+#ifdef _WIN32
+        ::shutdown(s, SD_BOTH);
+#else
+        ::shutdown(s, SHUT_RDWR);
+#endif
+    }
+
+    void accept_loop() {
+        while (!stopping) {
+            http_wire::socket_t s = ::accept(listener, nullptr, nullptr);
+            if (s == http_wire::BAD_SOCKET) continue;
+            int one = 1;
+            setsockopt(s, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&one), sizeof(one));
+            std::lock_guard<std::mutex> lock(mutex);
+            open_sockets.push_back(s);
+            handlers.emplace_back([this, s]() { serve(s); });
+        }
+    }
+
+    void serve(http_wire::socket_t s) {
+        std::string buffer;
+        http_wire::Message request;
+        std::vector<std::vector<double>> designs;
+        while (http_wire::read_message(s, buffer, request)) {
+            const long long number = ++m_requests;
+            if (m_latency_us > 0) std::this_thread::sleep_for(std::chrono::microseconds(m_latency_us));
+
+            if (m_fail_every > 0 && number % m_fail_every == 0) {
+                const std::string reply = "HTTP/1.1 503 Service Unavailable\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+                http_wire::send_all(s, reply.data(), reply.size());
+                break;
+            }
+
+            const bool binary = request.content_type.find("json") == std::string::npos;
+            std::string body, status = "200 OK";
+            if (http_wire::decode_designs(request.body, binary, designs)) {
+                std::vector<double> f(designs.size());
+                std::vector<std::vector<double>> g(designs.size());
+                Individual ind(n);
+                for (size_t i = 0; i < designs.size(); ++i) {
+                    ind.variables = designs[i];
+                    f[i] = objective(ind);
+                    g[i] = constraints(ind);
+                }
+                body = http_wire::encode_results(f, g, binary);
+            }
+            else {
+                status = "400 Bad Request";
+            }
+            std::string reply = "HTTP/1.1 " + status + "\r\nContent-Type: " + http_wire::content_type(binary) +
+                "\r\nContent-Length: " + std::to_string(body.size()) + (request.close ? "\r\nConnection: close" : "") +
+                "\r\n\r\n" + body;
+            if (!http_wire::send_all(s, reply.data(), reply.size()) || request.close) break;
+        }
+        if (!request.error.empty()) {
+            const std::string reply = "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+            http_wire::send_all(s, reply.data(), reply.size());
+        }
+        http_wire::close_socket(s);
+    }
+};
+
+int bench_http_evaluator() {
+    std::cout << "\n============================================================\n";
+    std::cout << "HTTP evaluation service: per-design vs batched, pipelined requests\n";
+    std::cout << "============================================================\n";
+
+    BenchProblem p = bench_problem4_2();
+    p.max_t = 20;
+    const int LATENCY_US = 200;
+    const unsigned SEED = 3;
+
+    Civilization reference(p.m, p.n, p.lb, p.ub, p.objective, p.constraints, SEED);
+    reference.set_verbose(false);
+    reference.initialize();
+    auto start = BenchClock::now();
+    run_time_steps(reference, p.max_t);
+    const double in_process_s = seconds_since(start);
+    const double reference_best = reference.get_best_ever().objective_value;
+
+    std::cout << p.name << ", m=" << p.m << ", T=" << p.max_t << ", " << reference.evaluations()
+        << " evaluations, service latency " << LATENCY_US << " us/request\n";
+    std::cout << std::left << std::setw(36) << "client" << std::right << std::setw(10) << "time (s)"
+        << std::setw(10) << "requests" << std::setw(10) << "connects" << std::setw(9) << "retries"
+        << std::setw(12) << "KB sent" << std::setw(11) << "same run" << "\n";
+    std::cout << std::left << std::setw(36) << "in-process" << std::right << std::fixed << std::setprecision(3)
+        << std::setw(10) << in_process_s << "\n";
+
+    struct Variant {
+        std::string label;
+        int batch_size, connections, in_flight;
+        bool keep_alive, binary;
+        int fail_every;
+        int runs; // concurrent runs sharing one client
+    };
+    const std::vector<Variant> variants = {
+        { "per design, new connection", 1, 1, 1, false, true, 0, 1 },
+        { "per design, keep-alive", 1, 1, 1, true, true, 0, 1 },
+        { "batch 25, 4 conns, JSON", 25, 4, 8, true, false, 0, 1 },
+        { "batch 25, 4 conns, binary", 25, 4, 8, true, true, 0, 1 },
+        { "batch 25, 4 conns, binary, 1/7 503", 25, 4, 8, true, true, 7, 1 },
+        { "batch 25, 4 conns, binary, 2 runs", 25, 4, 2, true, true, 0, 2 },
+    };
+
+    bool all_same = true;
+    double slowest = 0.0, fastest = std::numeric_limits<double>::max();
+    for (const auto& v : variants) {
+        StandInEvaluationServer server(p.n, p.objective, p.constraints, LATENCY_US, v.fail_every);
+        HttpEvaluator::Config config;
+        config.port = server.port();
+        config.batch_size = v.batch_size;
+        config.connections = v.connections;
+        config.max_in_flight = v.in_flight;
+        config.keep_alive = v.keep_alive;
+        config.binary = v.binary;
+        config.backoff_ms = 1;
+        HttpEvaluator client(config);
+
+        std::vector<std::unique_ptr<Civilization>> civs;
+        for (int r = 0; r < v.runs; ++r) {
+            civs.push_back(std::make_unique<Civilization>(p.m, p.n, p.lb, p.ub, p.objective, p.constraints, SEED));
+            civs.back()->set_verbose(false);
+            civs.back()->set_batch_evaluator([&client](const std::vector<Individual*>& batch) { client.evaluate(batch); });
+            civs.back()->initialize();
+        }
+        start = BenchClock::now();
+        std::vector<std::thread> threads;
+        for (auto& civ : civs) threads.emplace_back([&civ, &p]() { run_time_steps(*civ, p.max_t); });
+        for (auto& t : threads) t.join();
+        const double elapsed = seconds_since(start);
+
+        const auto st = client.stats();
+        bool same = true;
+        for (const auto& civ : civs) {
+            same = same && civ->evaluations() == reference.evaluations() &&
+                civ->get_best_ever().objective_value == reference_best;
+        }
+        all_same = all_same && same;
+        slowest = std::max(slowest, elapsed);
+        fastest = std::min(fastest, elapsed);
+        std::cout << std::left << std::setw(36) << v.label << std::right << std::setprecision(3)
+            << std::setw(10) << elapsed << std::setw(10) << st.requests << std::setw(10) << st.connects
+            << std::setw(9) << st.retries << std::setw(12) << std::setprecision(1) << st.bytes_sent / 1024.0
+            << std::setw(11) << (same ? "yes" : "NO") << "\n";
+    }
+    std::cout << "slowest / fastest client: " << std::setprecision(1) << slowest / fastest << "x\n";
+    std::cout << std::defaultfloat << std::setprecision(6);
+    return all_same ? 0 : 1;
+}
+
+// -------------------------------
+// License-token budget
+// -------------------------------
+int bench_license_budget() {
+    TaskRuntime& runtime = TaskRuntime::instance();
+    const int NUM_RUNS = 4;
+    const int TOKENS = 4;
+    const int m = 60;
+    const int MAX_T = 8;
+    const int SOLVER_US = 300; // a licensed solver call; sleeps, so it needs no core
+    const BenchProblem p = bench_problem4_2();
+
+    // Evaluations in progress over the whole process
+    std::atomic<int> running{ 0 }, peak{ 0 };
+    auto objective = [&](const Individual& ind) {
+        const int now = ++running;
+        int seen = peak.load();
+        while (now > seen && !peak.compare_exchange_weak(seen, now)) {}
+        std::this_thread::sleep_for(std::chrono::microseconds(SOLVER_US));
+        --running;
+        return p.objective(ind);
+    };
+
+    std::cout << "\n============================================================\n";
+    std::cout << "License-token budget: " << NUM_RUNS << " concurrent runs, " << TOKENS << " tokens, "
+        << SOLVER_US << " us per solver call\n";
+    std::cout << "runtime threads: " << runtime.max_threads() << " (use --threads 16 to oversubscribe the tokens)\n";
+    std::cout << "============================================================\n";
+    std::cout << std::left << std::setw(26) << "budget" << std::right << std::setw(10) << "time (s)"
+        << std::setw(12) << "peak evals" << std::setw(8) << "tokens" << std::setw(14) << "finish (s)"
+        << "   per-run wait (s)\n";
+
+    std::string token_dir = "license_tokens";
+#ifdef _WIN32
+    CreateDirectoryA(token_dir.c_str(), nullptr);
+#else
+    mkdir(token_dir.c_str(), 0777);
+#endif
+
+    // 0: unlimited, 1: one in-process pool, 2: two pools ("jobs") sharing a token directory
+    bool within_budget = true;
+    for (int mode = 0; mode < 3; ++mode) {
+        std::vector<std::shared_ptr<LicensePool>> pools;
+        if (mode == 1) pools.push_back(std::make_shared<LicensePool>(TOKENS));
+        if (mode == 2) {
+            pools.push_back(std::make_shared<LicensePool>(TOKENS, token_dir));
+            pools.push_back(std::make_shared<LicensePool>(TOKENS, token_dir));
+        }
+        std::vector<double> waits(NUM_RUNS, 0.0), finish(NUM_RUNS, 0.0);
+        running = 0;
+        peak = 0;
+
+        auto start = BenchClock::now();
+        runtime.parallel_for(0, NUM_RUNS, [&](int run) {
+            Civilization civ(m, p.n, p.lb, p.ub, objective, p.constraints, 500u + static_cast<unsigned>(run));
+            civ.set_verbose(false);
+            civ.set_parallel_evaluation(true);
+            if (!pools.empty()) civ.set_license_pool(pools[run % pools.size()], "run " + std::to_string(run + 1));
+            civ.initialize();
+            run_time_steps(civ, MAX_T);
+            waits[run] = civ.license_wait_seconds();
+            finish[run] = seconds_since(start);
+        });
+        const double elapsed = seconds_since(start);
+
+        const char* labels[] = { "unlimited", "one pool", "two jobs, shared token dir" };
+        std::cout << std::left << std::setw(26) << labels[mode] << std::right << std::fixed << std::setprecision(3)
+            << std::setw(10) << elapsed << std::setw(12) << peak.load()
+            << std::setw(8) << (mode == 0 ? std::string("-") : std::to_string(TOKENS))
+            << std::setw(7) << *std::min_element(finish.begin(), finish.end()) << "-"
+            << std::setw(6) << *std::max_element(finish.begin(), finish.end()) << "  ";
+        for (double w : waits) std::cout << " " << std::setw(7) << w;
+        std::cout << "\n";
+        if (mode > 0 && peak.load() > TOKENS) within_budget = false;
+    }
+    for (int k = 0; k < TOKENS; ++k) std::remove((token_dir + "/token." + std::to_string(k) + ".lock").c_str());
+#ifdef _WIN32
+    RemoveDirectoryA(token_dir.c_str());
+#else
+    rmdir(token_dir.c_str());
+#endif
+    std::cout << "peak within budget: " << (within_budget ? "yes" : "NO") << "\n";
+    std::cout << std::defaultfloat << std::setprecision(6);
+    return within_budget ? 0 : 1;
+}
+
+// -------------------------------
+// Bounded leader sets
+// -------------------------------
+int bench_leader_cap() {
+    const int NUM_RUNS = 8;
+    const int m = 400;
+    const int MAX_T = 50;
+
+    std::cout << "\n============================================================\n";
+    std::cout << "Bounded leader sets (top-k per society and super leaders)\n";
+    std::cout << "m=" << m << ", T=" << MAX_T << ", " << NUM_RUNS << " seeds; global phase = Steps 5-7\n";
+    std::cout << "============================================================\n";
+
+    for (const BenchProblem& p : { bench_problem4_1(), bench_problem4_2() }) {
+        std::cout << "\n" << p.name << " (target " << p.target << ")\n";
+        std::cout << std::left << std::setw(12) << "leaders" << std::right << std::setw(10) << "reached"
+            << std::setw(12) << "global L" << std::setw(10) << "supers" << std::setw(16) << "global (ms/t)"
+            << std::setw(14) << "step (ms/t)" << std::setw(14) << "mean best" << "\n";
+
+        for (int cap : { 0, 8, 3 }) {
+            int reached = 0, feasible = 0;
+            double sum_best = 0.0, sum_global = 0.0, sum_supers = 0.0, global_s = 0.0, total_s = 0.0;
+            for (int run = 0; run < NUM_RUNS; ++run) {
+                Civilization civ(m, p.n, p.lb, p.ub, p.objective, p.constraints, 900u + static_cast<unsigned>(run));
+                civ.set_verbose(false);
+                civ.set_max_leaders(cap);
+                civ.initialize();
+
+                double best = std::numeric_limits<double>::infinity();
+                auto start = BenchClock::now();
+                for (int t = 0; t < MAX_T; ++t) {
+                    civ.cluster_population();
+                    civ.identify_leaders();
+                    best = std::min(best, best_feasible_objective(civ.get_population()));
+                    civ.move_society_members();
+                    auto global_start = BenchClock::now();
+                    civ.form_global_society();
+                    civ.identify_super_leaders();
+                    civ.move_global_leaders();
+                    global_s += seconds_since(global_start);
+                    sum_global += static_cast<double>(civ.get_global_society().size());
+                    sum_supers += static_cast<double>(civ.get_super_leaders().size());
+                }
+                civ.evaluate_population();
+                total_s += seconds_since(start);
+                best = std::min(best, best_feasible_objective(civ.get_population()));
+
+                if (std::isfinite(best)) {
+                    feasible++;
+                    sum_best += best;
+                }
+                if (best <= p.target) reached++;
+            }
+            const double steps = static_cast<double>(NUM_RUNS) * MAX_T;
+            std::cout << std::left << std::setw(12) << (cap ? "top-" + std::to_string(cap) : std::string("all")) << std::right
+                << std::setw(8) << reached << "/" << NUM_RUNS << std::fixed << std::setprecision(1)
+                << std::setw(12) << sum_global / steps << std::setw(10) << sum_supers / steps
+                << std::setw(16) << std::setprecision(3) << 1e3 * global_s / steps
+                << std::setw(14) << 1e3 * total_s / steps
+                << std::setw(14) << std::setprecision(4) << (feasible ? sum_best / feasible : 0.0) << "\n";
+        }
+    }
+    std::cout << std::defaultfloat << std::setprecision(6);
+    return 0;
+}
+
+// -------------------------------
+// Trajectory CSV reader
+// -------------------------------
+
+// The parse most analysis scripts do: getline, split on commas, stod
+static size_t parse_log_with_streams(const std::string& path, std::vector<double>& objective) {
+    std::ifstream in(path);
+    std::string line, field;
+    std::getline(in, line); // header
+    size_t rows = 0;
+    while (std::getline(in, line)) {
+        std::stringstream ss(line);
+        double values[9];
+        int k = 0;
+        while (k < 9 && std::getline(ss, field, ',')) values[k++] = std::stod(field);
+        objective.push_back(values[5]);
+        rows++;
+    }
+    return rows;
+}
+
+// A realistic log: 'real_runs' problem 4.2 runs, repeated 'copies' times
+// under new run numbers
+static void write_bench_trajectory(const std::string& path, int real_runs, int copies) {
+    const BenchProblem p = bench_problem4_2();
+    std::ostringstream runs;
+    for (int r = 1; r <= real_runs; ++r) {
+        Civilization civ(p.m, p.n, p.lb, p.ub, p.objective, p.constraints, 70u + static_cast<unsigned>(r));
+        civ.set_verbose(false);
+        civ.initialize();
+        for (int t = 0; t < p.max_t; ++t) {
+            civ.step();
+            civ.log_state(runs, r, t);
+        }
+    }
+    std::ofstream out(path);
+    out << TrajectoryLog::CSV_HEADER << "\n";
+    const std::string block = runs.str();
+    for (int c = 0; c < copies; ++c) {
+        size_t at = 0;
+        while (at < block.size()) {
+            const size_t comma = block.find(',', at);
+            const size_t nl = block.find('\n', at);
+            out << std::stoi(block.substr(at, comma - at)) + c * real_runs;
+            out.write(block.data() + comma, static_cast<std::streamsize>(nl + 1 - comma));
+            at = nl + 1;
+        }
+    }
+}
+
+int bench_csv_reader() {
+    TaskRuntime& runtime = TaskRuntime::instance();
+    const std::string csv_path = "bench_trajectory.csv";
+    const std::string bin_path = "bench_trajectory.bin";
+    const int REAL_RUNS = 4, COPIES = 25;
+
+    const BenchProblem p = bench_problem4_2();
+    write_bench_trajectory(csv_path, REAL_RUNS, COPIES);
+
+    std::cout << "\n============================================================\n";
+    std::cout << "Trajectory CSV reader (" << REAL_RUNS * COPIES << " runs of " << p.name << ", "
+        << runtime.max_threads() << " runtime threads)\n";
+    std::cout << "============================================================\n";
+    std::cout << std::left << std::setw(34) << "reader" << std::right << std::setw(10) << "rows"
+        << std::setw(10) << "MB" << std::setw(12) << "time (ms)" << std::setw(10) << "MB/s" << "\n";
+
+    double csv_mb = 0.0;
+    auto row = [&](const std::string& label, size_t rows, double mb, double seconds) {
+        std::cout << std::left << std::setw(34) << label << std::right << std::setw(10) << rows
+            << std::fixed << std::setprecision(1) << std::setw(10) << mb
+            << std::setw(12) << 1e3 * seconds << std::setw(10) << mb / seconds << "\n";
+    };
+
+    std::vector<double> baseline;
+    auto start = BenchClock::now();
+    const size_t baseline_rows = parse_log_with_streams(csv_path, baseline);
+    const double baseline_s = seconds_since(start);
+
+    TrajectoryLog log;
+    start = BenchClock::now();
+    TrajectoryLog::ParseReport report = log.parse_csv(csv_path, 1);
+    const double serial_s = seconds_since(start);
+    csv_mb = static_cast<double>(report.bytes) / (1 << 20);
+    row("getline + stringstream + stod", baseline_rows, csv_mb, baseline_s);
+    row("TrajectoryLog, 1 chunk", report.rows, csv_mb, serial_s);
+
+    start = BenchClock::now();
+    report = log.parse_csv(csv_path);
+    row("TrajectoryLog, parallel chunks", report.rows, csv_mb, seconds_since(start));
+
+    log.write_binary(bin_path);
+    std::ifstream probe(bin_path, std::ios::binary | std::ios::ate);
+    const double bin_mb = static_cast<double>(probe.tellg()) / (1 << 20);
+    probe.close();
+    TrajectoryLog reloaded;
+    start = BenchClock::now();
+    reloaded.read_binary(bin_path);
+    row("binary format", reloaded.size(), bin_mb, seconds_since(start));
+
+    // Every parsed objective must equal what strtod gives
+    size_t mismatches = baseline.size() == log.size() ? 0 : baseline.size();
+    for (size_t i = 0; i < std::min(baseline.size(), log.size()); ++i) {
+        if (baseline[i] != log.objective[i]) mismatches++;
+    }
+    bool round_trip = reloaded.size() == log.size() && reloaded.steps().size() == log.steps().size();
+    for (size_t i = 0; round_trip && i < log.size(); ++i) {
+        round_trip = reloaded.run[i] == log.run[i] && reloaded.time[i] == log.time[i] &&
+            reloaded.x1[i] == log.x1[i] && reloaded.x2[i] == log.x2[i] && reloaded.flags[i] == log.flags[i];
+    }
+    std::cout << "steps indexed: " << log.steps().size() << ", split steps: " << report.split_steps
+        << ", objective mismatches vs stod: " << mismatches
+        << ", binary round trip: " << (round_trip ? "exact" : "DIFFERENT") << "\n";
+
+    // Validation on a damaged copy
+    {
+        std::ofstream out(csv_path, std::ios::app);
+        out << "1,0,5,1.0,2.0,3.0,0,2,0\n" << "1,0,6,abc,2.0,3.0,0,0,0\n" << "1,0,7,1.0,2.0\n";
+    }
+    report = log.parse_csv(csv_path);
+    std::cout << "damaged copy: " << report.errors << " rejected line(s)\n";
+    for (const auto& message : report.messages) std::cout << "  " << message << "\n";
+
+    std::remove(csv_path.c_str());
+    std::remove(bin_path.c_str());
+    std::cout << std::defaultfloat << std::setprecision(6);
+    return (mismatches == 0 && round_trip) ? 0 : 1;
+}
+
+// -------------------------------
+// Trajectory analytics
+// -------------------------------
+
+// What a one-off analysis script does: stream-parse every row, group rows by
+// (run, time) in a map, then summarise each group with sets
+struct ScriptStep {
+    double best = std::numeric_limits<double>::infinity();
+    int societies = 0;
+    int super_leaders = 0;
+};
+
+static std::map<std::pair<int, int>, ScriptStep> analyse_log_like_a_script(const std::string& path) {
+    struct Row { int cluster; double objective; int super_leader; };
+    std::map<std::pair<int, int>, std::vector<Row>> groups;
+    std::ifstream in(path);
+    std::string line, field;
+    std::getline(in, line); // header
+    while (std::getline(in, line)) {
+        std::stringstream ss(line);
+        double values[9];
+        int k = 0;
+        while (k < 9 && std::getline(ss, field, ',')) values[k++] = std::stod(field);
+        groups[{ static_cast<int>(values[0]), static_cast<int>(values[1]) }].push_back(
+            { static_cast<int>(values[6]), values[5], static_cast<int>(values[8]) });
+    }
+
+    std::map<std::pair<int, int>, ScriptStep> result;
+    for (const auto& g : groups) {
+        ScriptStep s;
+        std::set<int> clusters;
+        for (const Row& r : g.second) {
+            s.best = std::min(s.best, r.objective);
+            clusters.insert(r.cluster);
+            s.super_leaders += r.super_leader;
+        }
+        s.societies = static_cast<int>(clusters.size());
+        result[g.first] = s;
+    }
+    return result;
+}
+
+int bench_trajectory_analytics() {
+    TaskRuntime& runtime = TaskRuntime::instance();
+    const std::string csv_path = "bench_analytics.csv";
+    const std::string bin_path = "bench_analytics.bin";
+    const int REAL_RUNS = 4, COPIES = 25;
+    write_bench_trajectory(csv_path, REAL_RUNS, COPIES);
+
+    std::cout << "\n============================================================\n";
+    std::cout << "Trajectory analytics (" << REAL_RUNS * COPIES << " runs of " << bench_problem4_2().name << ", "
+        << runtime.max_threads() << " runtime threads)\n";
+    std::cout << "============================================================\n";
+    std::cout << std::left << std::setw(38) << "pipeline" << std::right << std::setw(12) << "load (ms)"
+        << std::setw(14) << "metrics (ms)" << std::setw(12) << "total (ms)" << "\n";
+    auto row = [](const std::string& label, double load_s, double metrics_s) {
+        std::cout << std::left << std::setw(38) << label << std::right << std::fixed << std::setprecision(1)
+            << std::setw(12) << 1e3 * load_s << std::setw(14) << 1e3 * metrics_s
+            << std::setw(12) << 1e3 * (load_s + metrics_s) << "\n";
+    };
+
+    auto start = BenchClock::now();
+    const auto script = analyse_log_like_a_script(csv_path);
+    row("getline + map/set per step", seconds_since(start), 0.0);
+
+    TrajectoryLog log;
+    TrajectoryAnalytics analytics;
+    start = BenchClock::now();
+    log.parse_csv(csv_path);
+    const double csv_load_s = seconds_since(start);
+    start = BenchClock::now();
+    analytics.compute(log);
+    row("TrajectoryAnalytics, CSV input", csv_load_s, seconds_since(start));
+
+    log.write_binary(bin_path);
+    TrajectoryLog reloaded;
+    start = BenchClock::now();
+    reloaded.read_binary(bin_path);
+    const double bin_load_s = seconds_since(start);
+    start = BenchClock::now();
+    analytics.compute(reloaded);
+    row("TrajectoryAnalytics, binary input", bin_load_s, seconds_since(start));
+
+    // Per-step figures must agree with the script
+    size_t mismatches = script.size() == analytics.steps.size() ? 0 : script.size();
+    for (const auto& s : analytics.steps) {
+        auto it = script.find({ s.run, s.time });
+        if (it == script.end() || it->second.best != s.best || it->second.societies != s.societies ||
+            it->second.super_leaders != s.super_leaders) {
+            mismatches++;
+        }
+    }
+
+    double switch_rate = 0.0, turnover = 0.0;
+    for (const auto& r : analytics.runs) {
+        switch_rate += r.switch_rate;
+        turnover += r.mean_super_turnover;
+    }
+    const double runs = static_cast<double>(std::max<size_t>(analytics.runs.size(), 1));
+    std::cout << "runs: " << analytics.runs.size() << ", steps: " << analytics.steps.size()
+        << ", mismatches vs script: " << mismatches << std::setprecision(3)
+        << ", mean super-leader turnover: " << turnover / runs
+        << ", society switches per agent-step: " << switch_rate / runs << "\n";
+
+    std::remove(csv_path.c_str());
+    std::remove(bin_path.c_str());
+    std::cout << std::defaultfloat << std::setprecision(6);
+    return mismatches == 0 ? 0 : 1;
+}
+
+// -------------------------------
+// Log / dump writer backends
+// -------------------------------
+
+// Forces the file to stable storage; returns the seconds it took
+static double sync_to_disk(const std::string& path) {
+    const auto start = BenchClock::now();
+#ifndef _WIN32
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        fsync(fd);
+        ::close(fd);
+    }
+#else
+    (void)path;
+#endif
+    return seconds_since(start);
+}
+
+int bench_block_writer() {
+    const std::string path = "bench_io.dat";
+    const size_t DUMP_MB = 256, RECORD = 4096;
+    const int CSV_STEPS = 40;
+
+    // A large civilization logged step after step (the CSV workload)
+    const BenchProblem p = bench_problem4_2();
+    Civilization civ(5000, p.n, p.lb, p.ub, p.objective, p.constraints, 5u);
+    civ.set_verbose(false);
+    civ.initialize();
+    civ.step();
+    std::vector<char> record(RECORD);
+    for (size_t k = 0; k < RECORD; ++k) record[k] = static_cast<char>('a' + k % 26);
+
+    struct Backend {
+        std::string label;
+        bool ofstream;
+        BlockWriter::Options options;
+    };
+    std::vector<Backend> backends;
+    backends.push_back({ "std::ofstream", true, BlockWriter::Options() });
+    BlockWriter::Options o;
+    o.use_io_uring = false;
+    backends.push_back({ "BlockWriter", false, o });
+    o.use_io_uring = true;
+    backends.push_back({ "BlockWriter", false, o });
+    o.direct = true;
+    backends.push_back({ "BlockWriter", false, o });
+
+    std::cout << "\n============================================================\n";
+    std::cout << "Log writer backends (" << DUMP_MB << " MB binary dump in " << RECORD << "-byte records; CSV log of "
+        << CSV_STEPS << " steps of a 5000-agent civilization)\n";
+    std::cout << "============================================================\n";
+    std::cout << std::left << std::setw(36) << "backend" << std::setw(6) << "load" << std::right
+        << std::setw(8) << "MB" << std::setw(12) << "write (ms)" << std::setw(14) << "+fsync (ms)"
+        << std::setw(10) << "MB/s" << std::setw(10) << "syscalls" << "\n";
+
+    for (int workload = 0; workload < 2; ++workload) {
+        for (const Backend& b : backends) {
+            std::string label = b.label;
+            long long syscalls = -1;
+            const auto start = BenchClock::now();
+            if (b.ofstream) {
+                std::ofstream out(path, std::ios::binary);
+                if (workload == 0) {
+                    for (size_t k = 0; k < DUMP_MB * (1 << 20) / RECORD; ++k) out.write(record.data(), RECORD);
+                }
+                else {
+                    for (int t = 0; t < CSV_STEPS; ++t) civ.log_state(out, 1, t);
+                }
+            }
+            else {
+                BlockWriter out(path, b.options);
+                label += " (" + std::string(out.backend()) + ")";
+                if (workload == 0) {
+                    for (size_t k = 0; k < DUMP_MB * (1 << 20) / RECORD; ++k) out.write(record.data(), RECORD);
+                }
+                else {
+                    for (int t = 0; t < CSV_STEPS; ++t) civ.log_state(out.stream(), 1, t);
+                }
+                out.close();
+                syscalls = out.stats().syscalls;
+            }
+            const double write_s = seconds_since(start);
+            const double sync_s = sync_to_disk(path);
+            std::ifstream probe(path, std::ios::binary | std::ios::ate);
+            const double mb = static_cast<double>(probe.tellg()) / (1 << 20);
+            probe.close();
+
+            // MB/s counts the data as written once it is on disk
+            std::cout << std::left << std::setw(36) << label << std::setw(6) << (workload == 0 ? "dump" : "csv")
+                << std::right << std::fixed << std::setprecision(1) << std::setw(8) << mb
+                << std::setw(12) << 1e3 * write_s << std::setw(14) << 1e3 * (write_s + sync_s)
+                << std::setw(10) << mb / (write_s + sync_s) << std::setw(10);
+            if (syscalls >= 0) std::cout << syscalls;
+            else std::cout << "-";
+            std::cout << "\n";
+        }
+    }
+    std::remove(path.c_str());
+    std::cout << std::defaultfloat << std::setprecision(6);
+    return 0;
+}
+
+// -------------------------------
+// Engine reuse across runs
+// -------------------------------
+
+int bench_engine_reuse() {
+    TaskRuntime& runtime = TaskRuntime::instance();
+    const BenchProblem p = bench_problem4_2();
+    const int RUNS = 2000, SHORT_T = 5;
+
+    auto configure = [](Civilization& civ) {
+        civ.set_verbose(false);
+        civ.set_adaptive_operators(true);
+        civ.set_epsilon_schedule(true, 3);
+    };
+    auto make_engine = [&](unsigned seed) {
+        auto civ = std::make_unique<Civilization>(p.m, p.n, p.lb, p.ub, p.objective, p.constraints, seed);
+        configure(*civ);
+        return civ;
+    };
+
+    std::cout << "\n============================================================\n";
+    std::cout << "Engine reuse (" << RUNS << " runs of " << p.name << ", " << SHORT_T << " steps each, "
+        << runtime.max_threads() << " runtime threads)\n";
+    std::cout << "============================================================\n";
+    std::cout << std::left << std::setw(34) << "setup" << std::right << std::setw(16) << "setup (us/run)"
+        << std::setw(14) << "total (ms)" << std::setw(10) << "engines" << "\n";
+
+    // Setup alone: construct + configure + initialize, against reseed()
+    auto start = BenchClock::now();
+    for (int r = 0; r < RUNS; ++r) make_engine(static_cast<unsigned>(r))->initialize();
+    const double fresh_setup_s = seconds_since(start);
+    auto reused = make_engine(0u);
+    start = BenchClock::now();
+    for (int r = 0; r < RUNS; ++r) reused->reseed(static_cast<unsigned>(r));
+    const double reseed_setup_s = seconds_since(start);
+
+    // Whole short runs, in parallel over the runtime
+    std::vector<double> fresh_best(RUNS), pooled_best(RUNS);
+    start = BenchClock::now();
+    runtime.parallel_for(0, RUNS, [&](int r) {
+        auto civ = make_engine(static_cast<unsigned>(r));
+        civ->initialize();
+        for (int t = 0; t < SHORT_T; ++t) civ->step();
+        fresh_best[r] = civ->get_best_solution().objective_value;
+    });
+    const double fresh_total_s = seconds_since(start);
+
+    CivilizationPool pool([&]() { return make_engine(0u); });
+    start = BenchClock::now();
+    runtime.parallel_for(0, RUNS, [&](int r) {
+        CivilizationPool::Lease civ = pool.acquire(static_cast<unsigned>(r));
+        for (int t = 0; t < SHORT_T; ++t) civ->step();
+        pooled_best[r] = civ->get_best_solution().objective_value;
+    });
+    const double pooled_total_s = seconds_since(start);
+
+    auto row = [&](const std::string& label, double setup_s, double total_s, int engines) {
+        std::cout << std::left << std::setw(34) << label << std::right << std::fixed << std::setprecision(2)
+            << std::setw(16) << 1e6 * setup_s / RUNS << std::setw(14) << std::setprecision(1) << 1e3 * total_s
+            << std::setw(10) << engines << "\n";
+    };
+    row("new Civilization per run", fresh_setup_s, fresh_total_s, RUNS);
+    row("reseed() on pooled engines", reseed_setup_s, pooled_total_s, pool.created());
+
+    int mismatches = 0;
+    for (int r = 0; r < RUNS; ++r) mismatches += fresh_best[r] != pooled_best[r];
+    std::cout << "runs whose best differs from a fresh engine: " << mismatches << "\n";
+    std::cout << std::defaultfloat << std::setprecision(6);
+    return mismatches == 0 ? 0 : 1;
+}
+
+// -------------------------------
+// Influence log
+// -------------------------------
+
+int bench_influence_log() {
+    const BenchProblem p = bench_problem4_2();
+    const int M = 1000, T = 50;
+    const std::string csv_path = "bench_influence.csv";
+    const std::string bin_path = "bench_influence.bin";
+
+    std::cout << "\n============================================================\n";
+    std::cout << "Influence log (" << p.name << ", m=" << M << ", " << T << " steps)\n";
+    std::cout << "============================================================\n";
+    std::cout << std::left << std::setw(20) << "tracking" << std::right << std::setw(14) << "step (ms)"
+        << std::setw(16) << "CSV bytes/row" << std::setw(16) << "bin bytes/row" << std::setw(14) << "best" << "\n";
+
+    double best[2] = { 0.0, 0.0 };
+    for (int tracked = 0; tracked < 2; ++tracked) {
+        Civilization civ(M, p.n, p.lb, p.ub, p.objective, p.constraints, 17u);
+        civ.set_verbose(false);
+        civ.set_influence_tracking(tracked != 0);
+        civ.initialize();
+
+        std::ostringstream rows;
+        double step_s = 0.0;
+        for (int t = 0; t < T; ++t) {
+            const auto start = BenchClock::now();
+            civ.step();
+            step_s += seconds_since(start);
+            civ.log_state(rows, 1, t);
+        }
+        best[tracked] = civ.get_best_solution().objective_value;
+        {
+            std::ofstream out(csv_path);
+            out << (tracked ? TrajectoryLog::CSV_HEADER_INFLUENCE : TrajectoryLog::CSV_HEADER) << "\n" << rows.str();
+        }
+        TrajectoryLog log;
+        log.parse_csv(csv_path);
+        log.write_binary(bin_path);
+        std::ifstream csv(csv_path, std::ios::binary | std::ios::ate), bin(bin_path, std::ios::binary | std::ios::ate);
+        const double n_rows = static_cast<double>(log.size());
+        std::cout << std::left << std::setw(20) << (tracked ? "on" : "off") << std::right << std::fixed
+            << std::setprecision(3) << std::setw(14) << 1e3 * step_s / T << std::setprecision(1)
+            << std::setw(16) << static_cast<double>(csv.tellg()) / n_rows
+            << std::setw(16) << static_cast<double>(bin.tellg()) / n_rows
+            << std::setw(14) << std::setprecision(6) << best[tracked] << "\n";
+    }
+
+    // Tree reconstruction for every step of the tracked log
+    TrajectoryLog log;
+    log.read_binary(bin_path);
+    double share = 0.0, max_share = 0.0;
+    int max_time = 0;
+    const auto start = BenchClock::now();
+    for (int t = 0; t < T; ++t) {
+        const InfluenceTree tree(log, 1, t);
+        share += tree.top_share();
+        if (tree.top_share() > max_share) {
+            max_share = tree.top_share();
+            max_time = t;
+        }
+    }
+    const double query_s = seconds_since(start);
+    std::cout << "influence trees: " << std::setprecision(3) << 1e3 * query_s / T << " ms per step, mean largest basin "
+        << std::setprecision(1) << 100.0 * share / T << "%, peak " << 100.0 * max_share << "% at t=" << max_time << "\n";
+    const InfluenceTree peak(log, 1, max_time);
+    peak.print(std::cout, 2, 4);
+
+    std::remove(csv_path.c_str());
+    std::remove(bin_path.c_str());
+    std::cout << std::defaultfloat << std::setprecision(6);
+    return best[0] == best[1] ? 0 : 1;
+}
+
+// -------------------------------
+// Interactive step latency
+// -------------------------------
+
+// Counting the allocations of step() means replacing the global operator
+// new, which would affect every mode of the program. It is therefore only
+// compiled into a separate measurement build:
+//   g++ -o solver_alloc society_civ/*.cpp -std=c++17 -O2 -pthread -DCIV_COUNT_ALLOCATIONS
+// Other builds report the allocation columns as n/a. The replacements are
+// kept out of line so that GCC does not flag the malloc/free inside them as
+// mismatched.
+#ifdef CIV_COUNT_ALLOCATIONS
+static std::atomic<long long> g_allocations{ 0 };
+
+#if defined(__GNUC__)
+#define BENCH_NOINLINE __attribute__((noinline))
+#else
+#define BENCH_NOINLINE
+#endif
+BENCH_NOINLINE void* operator new(std::size_t bytes) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(bytes ? bytes : 1)) return p;
+    throw std::bad_alloc();
+}
+BENCH_NOINLINE void operator delete(void* p) noexcept { std::free(p); }
+BENCH_NOINLINE void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+static long long allocations_so_far() { return g_allocations.load(std::memory_order_relaxed); }
+static const bool COUNTING_ALLOCATIONS = true;
+#else
+static long long allocations_so_far() { return 0; }
+static const bool COUNTING_ALLOCATIONS = false;
+#endif
+
+static double percentile(std::vector<double> values, double q) {
+    if (values.empty()) return 0.0;
+    const size_t k = static_cast<size_t>(q * (values.size() - 1) + 0.5);
+    std::nth_element(values.begin(), values.begin() + k, values.end());
+    return values[k];
+}
+
+int bench_step_latency() {
+    const BenchProblem p = bench_problem4_2();
+    const int M = 200, WARMUP = 5, STEPS = 2000, TICKS = 300;
+    const auto BUDGET = std::chrono::milliseconds(2);
+
+    std::cout << "\n============================================================\n";
+    std::cout << "Interactive step latency (" << p.name << ", m=" << M << ", " << STEPS << " steps after "
+        << WARMUP << " warm-up steps)\n";
+    std::cout << "============================================================\n";
+    std::cout << std::left << std::setw(40) << "setup" << std::right << std::setw(10) << "p50 (us)"
+        << std::setw(10) << "p99 (us)" << std::setw(10) << "max (us)" << std::setw(14) << "allocs/step"
+        << std::setw(16) << "steps w/ alloc" << "\n";
+
+    auto make_engine = [&](bool interactive, bool adaptive, bool capped) {
+        auto civ = std::make_unique<Civilization>(M, p.n, p.lb, p.ub, p.objective, p.constraints, 23u);
+        civ->set_verbose(false);
+        if (capped) civ->set_max_leaders(3);
+        if (adaptive) {
+            civ->set_adaptive_operators(true);
+            civ->set_epsilon_schedule(true, 50);
+        }
+        if (interactive) {
+            civ->set_constraint_writer([](const Individual& ind, std::vector<double>& out) {
+                welded_beam_problem.get_constraints_violation(ind, out);
+            });
+            civ->reserve_step_buffers();
+        }
+        civ->initialize();
+        return civ;
+    };
+
+    long long steady_allocations = 0;
+    double best[2] = { 0.0, 0.0 };
+    auto measure = [&](const std::string& label, bool interactive, bool adaptive, bool capped) {
+        auto civ = make_engine(interactive, adaptive, capped);
+        for (int t = 0; t < WARMUP; ++t) civ->step();
+
+        std::vector<double> micros(STEPS);
+        long long allocations = 0;
+        int allocating_steps = 0;
+        for (int t = 0; t < STEPS; ++t) {
+            const long long before = allocations_so_far();
+            const auto start = BenchClock::now();
+            civ->step();
+            micros[t] = 1e6 * seconds_since(start);
+            const long long made = allocations_so_far() - before;
+            allocations += made;
+            allocating_steps += made > 0;
+        }
+        if (interactive) steady_allocations += allocations;
+        if (!adaptive && !capped) best[interactive] = civ->get_best_ever().objective_value;
+
+        std::cout << std::left << std::setw(40) << label << std::right << std::fixed << std::setprecision(1)
+            << std::setw(10) << percentile(micros, 0.50) << std::setw(10) << percentile(micros, 0.99)
+            << std::setw(10) << *std::max_element(micros.begin(), micros.end()) << std::setprecision(2);
+        if (COUNTING_ALLOCATIONS) {
+            std::cout << std::setw(14) << static_cast<double>(allocations) / STEPS << std::setw(16) << allocating_steps << "\n";
+        }
+        else {
+            std::cout << std::setw(14) << "n/a" << std::setw(16) << "n/a" << "\n";
+        }
+    };
+    measure("step(), by-value constraints", false, false, false);
+    measure("step(), constraint writer + reserve", true, false, false);
+    measure("adaptive + epsilon, by-value", false, true, false);
+    measure("adaptive + epsilon, writer + reserve", true, true, false);
+    measure("3 leaders per society, by-value", false, false, true);
+    measure("3 leaders per society, writer + reserve", true, false, true);
+
+    // A UI timer: one step_for() call per tick
+    auto civ = make_engine(true, false, false);
+    std::vector<double> tick_ms(TICKS);
+    long long steps = 0;
+    int overruns = 0;
+    for (int k = 0; k < TICKS; ++k) {
+        const auto start = BenchClock::now();
+        steps += civ->step_for(BUDGET);
+        tick_ms[k] = 1e3 * seconds_since(start);
+        overruns += tick_ms[k] > std::chrono::duration<double, std::milli>(BUDGET).count();
+    }
+    std::cout << "step_for(" << BUDGET.count() << " ms) x " << TICKS << ": " << std::setprecision(1)
+        << static_cast<double>(steps) / TICKS << " steps per tick, tick p50 " << std::setprecision(3)
+        << percentile(tick_ms, 0.50) << " ms, p99 " << percentile(tick_ms, 0.99) << " ms, max "
+        << *std::max_element(tick_ms.begin(), tick_ms.end()) << " ms, " << overruns << " overrun(s)\n";
+
+    std::cout << "best matches between constraint functors: " << (best[0] == best[1] ? "yes" : "NO") << "\n";
+    if (!COUNTING_ALLOCATIONS) std::cout << "allocations not counted (build with -DCIV_COUNT_ALLOCATIONS)\n";
+    std::cout << std::defaultfloat << std::setprecision(6);
+    return steady_allocations == 0 && best[0] == best[1] ? 0 : 1;
+}
+
+// -------------------------------
+// Continuation over parameter sweeps
+// -------------------------------
+
+int bench_continuation() {
+    const BenchProblem p = bench_problem4_2();
+    const int INSTANCES = 9;
+
+    // Three load sweeps under different stress limits and one length sweep
+    struct Limits { double tau_max, sigma_max; };
+    const Limits limits[] = { { 13600.0, 30000.0 }, { 12000.0, 28000.0 }, { 15000.0, 32000.0 } };
+    std::vector<std::unique_ptr<WeldedBeamDesign>> problems;
+    std::vector<ContinuationSweep::Branch> branches;
+    auto add_instance = [&](ContinuationSweep::Branch& branch, double P, double L, double tau_max, double sigma_max) {
+        problems.push_back(std::make_unique<WeldedBeamDesign>(P, L, tau_max, sigma_max));
+        const WeldedBeamDesign* problem = problems.back().get();
+        std::ostringstream label;
+        label << "P=" << P << " L=" << L << " tau=" << tau_max << " sigma=" << sigma_max;
+        branch.push_back({ label.str(),
+            [problem](const Individual& ind) { return problem->get_objective(ind); },
+            [problem](const Individual& ind) { return problem->get_constraints_violation(ind); } });
+    };
+    for (const Limits& lim : limits) {
+        branches.emplace_back();
+        for (int k = 0; k < INSTANCES; ++k) add_instance(branches.back(), 6000.0 + 250.0 * k, 14.0, lim.tau_max, lim.sigma_max);
+    }
+    branches.emplace_back();
+    for (int k = 0; k < INSTANCES; ++k) add_instance(branches.back(), 6000.0, 14.0 - 0.5 * k, 13600.0, 30000.0);
+
+    ContinuationSweep::Options options;
+    options.pop_size = p.m;
+
+    std::cout << "\n============================================================\n";
+    std::cout << "Continuation over parameter sweeps (" << p.name << ", m=" << p.m << ", " << branches.size()
+        << " branches x " << INSTANCES << " instances, " << TaskRuntime::instance().max_threads() << " runtime threads)\n";
+    std::cout << "============================================================\n";
+
+    std::vector<ContinuationSweep::Result> runs[2];
+    double wall_s[2];
+    for (int warm = 0; warm < 2; ++warm) {
+        options.warm_start = warm != 0;
+        const ContinuationSweep sweep(p.n, p.lb, p.ub, options);
+        const auto start = BenchClock::now();
+        runs[warm] = sweep.solve(branches);
+        wall_s[warm] = seconds_since(start);
+    }
+
+    std::cout << std::left << std::setw(10) << "branch" << std::right << std::setw(14) << "cold evals"
+        << std::setw(14) << "warm evals" << std::setw(10) << "saved" << std::setw(18) << "mean obj change"
+        << std::setw(18) << "worst obj change" << std::setw(12) << "infeasible" << "\n";
+    long long total[2] = { 0, 0 };
+    double total_change = 0.0;
+    int compared = 0;
+    auto row = [&](const std::string& label, long long cold, long long warm, double mean_change, double worst, int infeasible) {
+        std::cout << std::left << std::setw(10) << label << std::right << std::setw(14) << cold << std::setw(14) << warm
+            << std::fixed << std::setprecision(1) << std::setw(9) << 100.0 * (cold - warm) / std::max(1LL, cold) << "%"
+            << std::setprecision(2) << std::setw(17) << 100.0 * mean_change << "%" << std::setw(17) << 100.0 * worst << "%"
+            << std::setw(12) << infeasible << "\n";
+    };
+    for (size_t b = 0; b < branches.size(); ++b) {
+        long long evals[2] = { 0, 0 };
+        double change = 0.0, worst = -INFINITY;
+        int infeasible = 0, count = 0;
+        for (size_t k = 0; k < runs[0].size(); ++k) {
+            if (runs[0][k].branch != (int)b) continue;
+            const ContinuationSweep::Result& cold = runs[0][k];
+            const ContinuationSweep::Result& warm = runs[1][k];
+            evals[0] += cold.evaluations;
+            evals[1] += warm.evaluations;
+            if (!Civilization::is_feasible(warm.best)) infeasible++;
+            // Relative objective change of the warm start (negative: better)
+            const double c = (warm.best.objective_value - cold.best.objective_value) / std::abs(cold.best.objective_value);
+            change += c;
+            worst = std::max(worst, c);
+            count++;
+        }
+        total[0] += evals[0];
+        total[1] += evals[1];
+        total_change += change;
+        compared += count;
+        row(std::to_string(b), evals[0], evals[1], count ? change / count : 0.0, worst, infeasible);
+    }
+    std::cout << std::string(96, '-') << "\n";
+    int infeasible = 0;
+    double worst = -INFINITY;
+    for (size_t k = 0; k < runs[0].size(); ++k) {
+        if (!Civilization::is_feasible(runs[1][k].best)) infeasible++;
+        worst = std::max(worst, (runs[1][k].best.objective_value - runs[0][k].best.objective_value) / std::abs(runs[0][k].best.objective_value));
+    }
+    row("all", total[0], total[1], compared ? total_change / compared : 0.0, worst, infeasible);
+    std::cout << "wall time: cold " << std::setprecision(0) << 1e3 * wall_s[0] << " ms, warm " << 1e3 * wall_s[1] << " ms\n";
+    std::cout << std::defaultfloat << std::setprecision(6);
+    return total[1] < total[0] ? 0 : 1;
+}
+
+// -------------------------------
+// Cheap-constraint repair
+// -------------------------------
+
+int bench_cheap_repair() {
+    TaskRuntime& runtime = TaskRuntime::instance();
+    const BenchProblem p = bench_problem4_2();
+    const int RUNS = 30;
+    const LinearConstraints cheap = welded_beam_problem.linear_constraints();
+
+    std::cout << "\n============================================================\n";
+    std::cout << "Cheap-constraint repair (" << RUNS << " runs of " << p.name << ", m=" << p.m << ", "
+        << p.max_t << " steps; cheap constraints g3: h <= b, g5: h >= 0.125)\n";
+    std::cout << "============================================================\n";
+    std::cout << std::left << std::setw(12) << "repair" << std::right << std::setw(14) << "evals/run"
+        << std::setw(20) << "cheap-infeasible" << std::setw(14) << "projected" << std::setw(12) << "rejected"
+        << std::setw(14) << "mean best" << std::setw(10) << "solved" << "\n";
+
+    const std::pair<const char*, Civilization::RepairMode> modes[] = {
+        { "none", Civilization::REPAIR_NONE },
+        { "project", Civilization::REPAIR_PROJECT },
+        { "reject", Civilization::REPAIR_REJECT } };
+    long long wasted_with_repair = 0;
+    for (const auto& mode : modes) {
+        // Evaluations spent on points the cheap constraints already rule out
+        std::atomic<long long> wasted{ 0 };
+        Civilization::ObjFunc objective = [&](const Individual& ind) {
+            if (!cheap.satisfied(ind.variables.data())) wasted++;
+            return p.objective(ind);
+        };
+
+        std::vector<long long> evals(RUNS);
+        std::vector<Civilization::RepairStats> stats(RUNS);
+        std::vector<double> best(RUNS);
+        runtime.parallel_for(0, RUNS, [&](int r) {
+            Civilization civ(p.m, p.n, p.lb, p.ub, objective, p.constraints, 300u + static_cast<unsigned>(r));
+            civ.set_verbose(false);
+            civ.set_repair(mode.second, mode.second == Civilization::REPAIR_NONE ? LinearConstraints() : cheap);
+            civ.initialize();
+            for (int t = 0; t < p.max_t; ++t) civ.step();
+            evals[r] = civ.evaluations();
+            stats[r] = civ.get_repair_stats();
+            best[r] = civ.has_best_ever() && Civilization::is_feasible(civ.get_best_ever())
+                ? civ.get_best_ever().objective_value : std::numeric_limits<double>::infinity();
+        });
+
+        double eval_sum = 0.0, projected = 0.0, rejected = 0.0, best_sum = 0.0;
+        int solved = 0, feasible = 0;
+        for (int r = 0; r < RUNS; ++r) {
+            eval_sum += evals[r];
+            projected += stats[r].projected;
+            rejected += stats[r].rejected;
+            if (std::isfinite(best[r])) {
+                best_sum += best[r];
+                feasible++;
+            }
+            solved += best[r] <= p.target;
+        }
+        if (mode.second != Civilization::REPAIR_NONE) wasted_with_repair += wasted;
+        std::cout << std::left << std::setw(12) << mode.first << std::right << std::fixed << std::setprecision(0)
+            << std::setw(14) << eval_sum / RUNS << std::setw(20) << static_cast<double>(wasted) / RUNS
+            << std::setw(14) << projected / RUNS << std::setw(12) << rejected / RUNS << std::setprecision(4)
+            << std::setw(14) << (feasible ? best_sum / feasible : 0.0) << std::setw(7) << solved << "/" << RUNS << "\n";
+    }
+    std::cout << "(per-run means; cheap-infeasible = evaluations of points violating g3 or g5)\n";
+    std::cout << std::defaultfloat << std::setprecision(6);
+    return wasted_with_repair == 0 ? 0 : 1;
+}
+
+// -------------------------------
+// Hot/cold layout
+// -------------------------------
+
+int bench_hot_cold() {
+    const BenchProblem p = bench_problem4_2();
+    struct Setup { int m, n, steps; };
+    const Setup setups[] = { { 1000, 4, 40 }, { 2000, 4, 20 }, { 1000, 30, 3 } };
+
+    std::cout << "\n============================================================\n";
+    std::cout << "Hot/cold layout (" << p.name << ", extra variables unused by the objective)\n";
+    std::cout << "============================================================\n";
+
+    // Step phases
+    std::cout << std::left << std::setw(14) << "m x n" << std::right << std::setw(12) << "cluster" << std::setw(12)
+        << "leaders" << std::setw(12) << "move" << std::setw(12) << "super" << std::setw(12) << "global"
+        << std::setw(12) << "total" << "   (ms/step)\n";
+    double checksum = 0.0;
+    for (const Setup& s : setups) {
+        std::vector<double> lb = p.lb, ub = p.ub;
+        lb.resize(s.n, 0.1);
+        ub.resize(s.n, 2.0);
+        Civilization civ(s.m, s.n, lb, ub, p.objective, p.constraints, 5u);
+        civ.set_verbose(false);
+        civ.set_constraint_writer([](const Individual& ind, std::vector<double>& out) {
+            welded_beam_problem.get_constraints_violation(ind, out);
+        });
+        civ.initialize();
+
+        double phase[5] = { 0.0, 0.0, 0.0, 0.0, 0.0 };
+        for (int t = 0; t < s.steps; ++t) {
+            auto start = BenchClock::now();
+            civ.cluster_population();
+            phase[0] += seconds_since(start);
+            start = BenchClock::now();
+            civ.identify_leaders();
+            phase[1] += seconds_since(start);
+            start = BenchClock::now();
+            civ.move_society_members();
+            phase[2] += seconds_since(start);
+            start = BenchClock::now();
+            civ.form_global_society();
+            civ.identify_super_leaders();
+            phase[3] += seconds_since(start);
+            start = BenchClock::now();
+            civ.move_global_leaders();
+            phase[4] += seconds_since(start);
+        }
+        std::ostringstream label;
+        label << s.m << " x " << s.n;
+        std::cout << std::left << std::setw(14) << label.str() << std::right << std::fixed << std::setprecision(2);
+        double total = 0.0;
+        for (double t : phase) {
+            std::cout << std::setw(12) << 1e3 * t / s.steps;
+            total += t;
+        }
+        std::cout << std::setw(12) << 1e3 * total / s.steps << "\n";
+        checksum += civ.get_best_ever().objective_value;
+    }
+
+    // The layout effect alone: all-pairs distances over the same positions,
+    // read through the Individuals (as the step loops do) and through one
+    // flat copy, the cost a structure-of-arrays layout could save
+    std::cout << "\nall-pairs distances    " << std::setw(16) << "Individuals (ms)" << std::setw(14) << "flat (ms)"
+        << std::setw(10) << "speedup" << "\n";
+    for (const Setup& s : setups) {
+        std::vector<double> lb = p.lb, ub = p.ub;
+        lb.resize(s.n, 0.1);
+        ub.resize(s.n, 2.0);
+        Civilization civ(s.m, s.n, lb, ub, p.objective, p.constraints, 5u);
+        civ.set_verbose(false);
+        civ.initialize();
+        const std::vector<Individual>& population = civ.get_population();
+
+        auto start = BenchClock::now();
+        double cold_sum = 0.0;
+        for (int a = 0; a < s.m; ++a) {
+            for (int b = 0; b < s.m; ++b) cold_sum += civ.calculate_distance(population[a], population[b]);
+        }
+        const double cold = seconds_since(start);
+
+        start = BenchClock::now();
+        std::vector<double> flat(static_cast<size_t>(s.m) * s.n);
+        for (int a = 0; a < s.m; ++a) std::copy(population[a].variables.begin(), population[a].variables.end(), flat.begin() + static_cast<size_t>(a) * s.n);
+        double hot_sum = 0.0;
+        for (int a = 0; a < s.m; ++a) {
+            const double* x = flat.data() + static_cast<size_t>(a) * s.n;
+            for (int b = 0; b < s.m; ++b) {
+                const double* y = flat.data() + static_cast<size_t>(b) * s.n;
+                double sum = 0.0;
+                for (int i = 0; i < s.n; ++i) {
+                    const double diff = x[i] - y[i];
+                    sum += diff * diff;
+                }
+                hot_sum += std::sqrt(sum);
+            }
+        }
+        const double hot = seconds_since(start);
+        checksum += cold_sum - hot_sum;
+
+        std::ostringstream label;
+        label << s.m << " x " << s.n;
+        std::cout << std::left << std::setw(23) << label.str() << std::right << std::setprecision(2)
+            << std::setw(16) << 1e3 * cold << std::setw(14) << 1e3 * hot << std::setw(9) << cold / hot << "x"
+            << (cold_sum == hot_sum ? "" : "  (sums differ)") << "\n";
+    }
+    std::cout << "checksum " << std::defaultfloat << std::setprecision(6) << checksum << "\n";
+    return 0;
+}
+
+// -------------------------------
+// Bandit allocation of evaluations across societies
+// -------------------------------
+
+int bench_evaluation_bandit() {
+    const int NUM_RUNS = 30;
+    const long long BUDGET = 10000; // evaluations per run
+    std::cout << "\n============================================================\n";
+    std::cout << "Evaluations to target: every follower moves vs bandit allocation across societies\n";
+    std::cout << "(" << NUM_RUNS << " seeds per configuration, " << BUDGET << " evaluations per run; 'uniform' thins\n";
+    std::cout << " every society alike, 'bandit' shares the same budget out by recent improvement rate)\n";
+    std::cout << "============================================================\n";
+
+    for (BenchProblem problem : { bench_problem4_1(), bench_problem4_2() }) {
+        problem.max_t = static_cast<int>(4 * BUDGET / problem.m); // the budget ends every run
+        print_target_header(problem);
+        report_target_study(problem, "all followers move",
+            [](Civilization&) {}, NUM_RUNS, 1100, BUDGET);
+        report_target_study(problem, "uniform 50%",
+            [](Civilization& civ) { civ.set_evaluation_bandit(true, 0.5, 0.5); }, NUM_RUNS, 1100, BUDGET);
+        report_target_study(problem, "bandit 50%, min 10%",
+            [](Civilization& civ) { civ.set_evaluation_bandit(true, 0.5, 0.1); }, NUM_RUNS, 1100, BUDGET);
+        report_target_study(problem, "uniform 25%",
+            [](Civilization& civ) { civ.set_evaluation_bandit(true, 0.25, 0.25); }, NUM_RUNS, 1100, BUDGET);
+        report_target_study(problem, "bandit 25%, min 5%",
+            [](Civilization& civ) { civ.set_evaluation_bandit(true, 0.25, 0.05); }, NUM_RUNS, 1100, BUDGET);
+    }
+    return 0;
+}
+
+// -------------------------------
+// Cross-run evaluation coalescing
+// -------------------------------
+
+int bench_evaluation_coalescer() {
+    const BenchProblem p = bench_problem4_2();
+    const int NUM_RUNS = 8, MAX_T = 30;
+    const int CALL_US = 2000, DESIGN_US = 10; // stand-in service: per-call overhead, per-design cost
+
+    // A service with one worker: calls are served one at a time and cost
+    // CALL_US plus DESIGN_US per design (sleeps, so it needs no core)
+    std::mutex service;
+    std::atomic<long long> calls{ 0 };
+    double busy_seconds = 0.0;
+    auto serve = [&](const std::vector<Individual*>& batch) {
+        std::lock_guard<std::mutex> lock(service);
+        const auto start = BenchClock::now();
+        std::this_thread::sleep_for(std::chrono::microseconds(CALL_US + DESIGN_US * static_cast<long long>(batch.size())));
+        for (Individual* ind : batch) {
+            ind->objective_value = p.objective(*ind);
+            ind->constraint_violations = p.constraints(*ind);
+        }
+        calls++;
+        busy_seconds += seconds_since(start);
+    };
+
+    std::cout << "\n============================================================\n";
+    std::cout << "Cross-run evaluation coalescing: " << NUM_RUNS << " concurrent runs of " << p.name << ", m=" << p.m
+        << ", T=" << MAX_T << "\n";
+    std::cout << "stand-in service: one call at a time, " << CALL_US << " us per call + " << DESIGN_US << " us per design\n";
+    std::cout << "============================================================\n";
+    std::cout << std::left << std::setw(30) << "evaluator" << std::right << std::setw(10) << "time (s)" << std::setw(8)
+        << "calls" << std::setw(12) << "mean batch" << std::setw(12) << "designs/s" << std::setw(11) << "same runs" << "\n";
+
+    // One thread per run, as the runs of a study or the islands of a model would have
+    std::vector<double> reference_best(NUM_RUNS);
+    std::vector<long long> reference_evals(NUM_RUNS);
+    auto run_all = [&](const std::function<Civilization::BatchEvalFunc()>& make_evaluator, bool reference) {
+        std::vector<double> best(NUM_RUNS);
+        std::vector<long long> evals(NUM_RUNS);
+        std::vector<std::thread> threads;
+        for (int run = 0; run < NUM_RUNS; ++run) {
+            Civilization::BatchEvalFunc evaluator = make_evaluator();
+            threads.emplace_back([&, run, evaluator]() mutable {
+                Civilization civ(p.m, p.n, p.lb, p.ub, p.objective, p.constraints, 1200u + static_cast<unsigned>(run));
+                civ.set_verbose(false);
+                civ.set_batch_evaluator(std::move(evaluator));
+                civ.initialize();
+                run_time_steps(civ, MAX_T);
+                best[run] = civ.get_best_ever().objective_value;
+                evals[run] = civ.evaluations();
+            });
+        }
+        for (auto& t : threads) t.join();
+        if (reference) {
+            reference_best = best;
+            reference_evals = evals;
+        }
+        return best == reference_best && evals == reference_evals;
+    };
+
+    bool all_same = true;
+    auto report = [&](const std::string& label, double elapsed, bool same) {
+        const long long designs = std::accumulate(reference_evals.begin(), reference_evals.end(), 0LL);
+        std::cout << std::left << std::setw(30) << label << std::right << std::fixed << std::setprecision(3)
+            << std::setw(10) << elapsed << std::setw(8) << calls.load() << std::setw(12) << std::setprecision(1)
+            << static_cast<double>(designs) / calls.load() << std::setw(12) << std::setprecision(0) << designs / elapsed
+            << std::setw(11) << (same ? "yes" : "NO") << "   service busy " << std::setprecision(0)
+            << 100.0 * busy_seconds / elapsed << "%\n";
+        all_same = all_same && same;
+    };
+
+    auto start = BenchClock::now();
+    run_all([&]() { return Civilization::BatchEvalFunc(serve); }, true);
+    report("one call per run and step", seconds_since(start), true);
+
+    for (int wait_us : { 500, 5000 }) {
+        calls = 0;
+        busy_seconds = 0.0;
+        EvaluationCoalescer::Options options;
+        options.max_wait = std::chrono::microseconds(wait_us);
+        EvaluationCoalescer coalescer(serve, options);
+        start = BenchClock::now();
+        const bool same = run_all([&]() { return coalescer.client(); }, false);
+        const double elapsed = seconds_since(start);
+        report("coalesced, max wait " + std::to_string(wait_us) + " us", elapsed, same);
+        const auto st = coalescer.stats();
+        std::cout << "    " << st.requests << " requests in " << st.dispatches << " calls (largest " << st.largest_batch
+            << " designs), rounds closed: " << st.full_rounds << " all clients waiting, " << st.timed_out_rounds << " max wait\n";
+    }
+    std::cout << std::defaultfloat << std::setprecision(6);
+    return all_same ? 0 : 1;
+}
+
+// -------------------------------
+// Society size limits
+// -------------------------------
+
+int bench_society_limits() {
+    const int NUM_RUNS = 8;
+    const int m = 400;
+    const int MAX_T = 50;
+    struct Limits { const char* label; int max_hubs, min_size; };
+    const Limits configs[] = { { "none", 0, 0 }, { "hubs<=16", 16, 0 }, { "size>=5", 0, 5 }, { "both", 16, 5 } };
+
+    std::cout << "\n============================================================\n";
+    std::cout << "Society size limits (hub-count cap, merging of small societies)\n";
+    std::cout << "m=" << m << ", T=" << MAX_T << ", " << NUM_RUNS << " seeds; sizes over all societies of all steps\n";
+    std::cout << "============================================================\n";
+
+    // Hub-center clustering fragments in higher dimensions: the welded beam
+    // padded with 12 variables the objective ignores
+    BenchProblem padded = bench_problem4_2();
+    padded.name = "problem4_2 + 12 inactive variables";
+    padded.n = 16;
+    padded.lb.resize(padded.n, 0.1);
+    padded.ub.resize(padded.n, 2.0);
+
+    for (const BenchProblem& p : { bench_problem4_1(), bench_problem4_2(), padded }) {
+        std::cout << "\n" << p.name << " (target " << p.target << ")\n";
+        std::cout << std::left << std::setw(10) << "limits" << std::right << std::setw(10) << "reached"
+            << std::setw(11) << "societies" << std::setw(12) << "singletons" << std::setw(18) << "size p10/50/90"
+            << std::setw(7) << "max" << std::setw(10) << "global L" << std::setw(13) << "step (ms/t)"
+            << std::setw(12) << "mean best" << "\n";
+
+        for (const Limits& limits : configs) {
+            int reached = 0, feasible = 0;
+            double sum_best = 0.0, sum_global = 0.0, total_s = 0.0;
+            std::vector<double> sizes;
+            std::vector<int> count;
+            for (int run = 0; run < NUM_RUNS; ++run) {
+                Civilization civ(m, p.n, p.lb, p.ub, p.objective, p.constraints, 1300u + static_cast<unsigned>(run));
+                civ.set_verbose(false);
+                civ.set_society_limits(limits.max_hubs, limits.min_size);
+                civ.initialize();
+
+                double best = std::numeric_limits<double>::infinity();
+                auto start = BenchClock::now();
+                for (int t = 0; t < MAX_T; ++t) {
+                    civ.cluster_population();
+                    civ.identify_leaders();
+                    best = std::min(best, best_feasible_objective(civ.get_population()));
+                    civ.move_society_members();
+                    civ.form_global_society();
+                    civ.identify_super_leaders();
+                    civ.move_global_leaders();
+                    sum_global += static_cast<double>(civ.get_global_society().size());
+
+                    count.assign(m, 0);
+                    for (int s : civ.get_assignments()) count[s]++;
+                    for (int c : count) {
+                        if (c > 0) sizes.push_back(c);
+                    }
+                }
+                civ.evaluate_population();
+                total_s += seconds_since(start);
+                best = std::min(best, best_feasible_objective(civ.get_population()));
+
+                if (std::isfinite(best)) {
+                    feasible++;
+                    sum_best += best;
+                }
+                if (best <= p.target) reached++;
+            }
+            const double steps = static_cast<double>(NUM_RUNS) * MAX_T;
+            const double singletons = static_cast<double>(std::count(sizes.begin(), sizes.end(), 1.0));
+            std::ostringstream quantiles;
+            quantiles << percentile(sizes, 0.1) << "/" << percentile(sizes, 0.5) << "/" << percentile(sizes, 0.9);
+            std::cout << std::left << std::setw(10) << limits.label << std::right
+                << std::setw(8) << reached << "/" << NUM_RUNS << std::fixed << std::setprecision(1)
+                << std::setw(11) << sizes.size() / steps << std::setw(11) << 100.0 * singletons / sizes.size() << "%"
+                << std::setw(18) << quantiles.str() << std::setw(7) << *std::max_element(sizes.begin(), sizes.end())
+                << std::setw(10) << sum_global / steps << std::setw(13) << std::setprecision(3) << 1e3 * total_s / steps
+                << std::setw(12) << std::setprecision(4) << (feasible ? sum_best / feasible : 0.0) << "\n";
+        }
+    }
+    std::cout << std::defaultfloat << std::setprecision(6);
+    return 0;
+}
+
+// -------------------------------
+// Triangle-inequality pruning in clustering
+// -------------------------------
+
+// Hub-center clustering as the paper states it, without caches or pruning:
+// every distance is computed afresh. 'first_hub' is the randomly drawn first
+// hub of the clustering under test; fills 'hubs' and returns the assignments.
+static std::vector<int> reference_clustering(const std::vector<Individual>& pop, int first_hub, std::vector<int>& hubs) {
+    auto distance = [&](int a, int b) {
+        double sum = 0.0;
+        for (size_t i = 0; i < pop[a].variables.size(); ++i) {
+            const double diff = pop[a].variables[i] - pop[b].variables[i];
+            sum += diff * diff;
+        }
+        return std::sqrt(sum);
+    };
+    const int m = static_cast<int>(pop.size());
+    hubs.assign(1, first_hub);
+    int second_hub = -1;
+    double max_dist = -1.0;
+    for (int i = 0; i < m; ++i) {
+        const double d = distance(i, hubs[0]);
+        if (d > max_dist) { max_dist = d; second_hub = i; }
+    }
+    hubs.push_back(second_hub);
+
+    std::vector<int> assignments(m);
+    for (int i = 0; i < m; ++i) assignments[i] = distance(i, hubs[0]) <= distance(i, hubs[1]) ? 0 : 1;
+    while (true) {
+        double total_dist = 0.0;
+        int pairs = 0;
+        for (size_t i = 0; i < hubs.size(); ++i) {
+            for (size_t j = i + 1; j < hubs.size(); ++j) {
+                total_dist += distance(hubs[i], hubs[j]);
+                pairs++;
+            }
+        }
+        const double D = pairs > 0 ? (total_dist / pairs) / 2.0 : 0.0;
+
+        int farthest = -1;
+        double max_d = -1.0;
+        for (int i = 0; i < m; ++i) {
+            const double d = distance(i, hubs[assignments[i]]);
+            if (d > max_d) { max_d = d; farthest = i; }
+        }
+        if (max_d <= D) break;
+
+        hubs.push_back(farthest);
+        const int new_hub = static_cast<int>(hubs.size()) - 1;
+        for (int i = 0; i < m; ++i) {
+            if (distance(i, farthest) < distance(i, hubs[assignments[i]])) assignments[i] = new_hub;
+        }
+    }
+    return assignments;
+}
+
+int bench_cluster_pruning() {
+    const BenchProblem p = bench_problem4_2();
+    struct Setup { int m, n, steps; };
+    const Setup setups[] = { { 400, 4, 50 }, { 1000, 4, 30 }, { 400, 16, 20 }, { 1000, 30, 5 } };
+
+    // Runs 'steps' steps, checking every clustering against the reference
+    // (outside the timed part); counts the clusterings and any mismatches
+    long long checked = 0, mismatches = 0;
+    std::vector<int> reference_hubs;
+    auto run = [&](Civilization& civ, int steps, double* cluster_s, double* hubs) {
+        for (int t = 0; t < steps; ++t) {
+            const auto start = BenchClock::now();
+            civ.cluster_population();
+            if (cluster_s) *cluster_s += seconds_since(start);
+            if (hubs) *hubs += static_cast<double>(civ.get_hubs().size());
+
+            const std::vector<int> reference = reference_clustering(civ.get_population(), civ.get_hubs()[0], reference_hubs);
+            checked++;
+            if (reference != civ.get_assignments() || reference_hubs != civ.get_hubs()) mismatches++;
+
+            civ.identify_leaders();
+            civ.move_society_members();
+            civ.form_global_society();
+            civ.identify_super_leaders();
+            civ.move_global_leaders();
+        }
+    };
+    auto make = [&](int m, int n, unsigned seed) {
+        std::vector<double> lb = p.lb, ub = p.ub;
+        lb.resize(n, 0.1);
+        ub.resize(n, 2.0);
+        // The welded beam needs its 4 variables; narrower shapes get a sphere
+        Civilization::ObjFunc objective = p.objective;
+        Civilization::ConFunc constraints = p.constraints;
+        if (n < 4) {
+            objective = [](const Individual& ind) {
+                double sum = 0.0;
+                for (double x : ind.variables) sum += x * x;
+                return sum;
+            };
+            constraints = [](const Individual& ind) {
+                double sum = 0.0;
+                for (double x : ind.variables) sum += x;
+                return std::vector<double>{ std::max(0.0, 1.5 - sum) };
+            };
+        }
+        auto civ = std::make_unique<Civilization>(m, n, lb, ub, objective, constraints, seed);
+        civ->set_verbose(false);
+        civ->initialize();
+        return civ;
+    };
+
+    std::cout << "\n============================================================\n";
+    std::cout << "Hub-center clustering: cached and pruned distances (" << p.name << ", extra variables unused)\n";
+    std::cout << "'naive' = distances the loop computed before caching and pruning\n";
+    std::cout << "============================================================\n";
+    std::cout << std::left << std::setw(12) << "m x n" << std::right << std::setw(8) << "hubs" << std::setw(14)
+        << "computed" << std::setw(14) << "naive" << std::setw(10) << "avoided" << std::setw(10) << "pruned"
+        << std::setw(16) << "cluster (ms/t)" << "\n";
+    for (const Setup& s : setups) {
+        auto civ = make(s.m, s.n, 5u);
+        double cluster_s = 0.0, hubs = 0.0;
+        run(*civ, s.steps, &cluster_s, &hubs);
+        const auto& st = civ->clustering_search_stats();
+        const long long naive = st.distance_evals + st.reused + st.pruned;
+        std::ostringstream label;
+        label << s.m << " x " << s.n;
+        std::cout << std::left << std::setw(12) << label.str() << std::right << std::fixed << std::setprecision(1)
+            << std::setw(8) << hubs / s.steps << std::setw(14) << st.distance_evals / s.steps << std::setw(14)
+            << naive / s.steps << std::setw(9) << 100.0 * (naive - st.distance_evals) / naive << "%"
+            << std::setw(9) << 100.0 * st.pruned / naive << "%" << std::setw(16) << std::setprecision(3)
+            << 1e3 * cluster_s / s.steps << "\n";
+    }
+    std::cout << "(per step; avoided = reused from the caches or pruned)\n";
+
+    // Further shapes, several seeds each, only checked against the reference
+    for (int m : { 100, 600 }) {
+        for (int n : { 2, 4, 16, 30 }) {
+            for (unsigned seed = 1; seed <= 3; ++seed) {
+                auto civ = make(m, n, seed);
+                run(*civ, 20, nullptr, nullptr);
+            }
+        }
+    }
+    std::cout << "societies and hubs equal to the unpruned reference: " << checked - mismatches << "/" << checked
+        << " clusterings" << (mismatches ? "  MISMATCH" : "") << "\n";
+    std::cout << std::defaultfloat << std::setprecision(6);
+    return mismatches == 0 ? 0 : 1;
+}
+
+// -------------------------------
+// Evaluation record and replay
+// -------------------------------
+
+int bench_evaluation_replay() {
+    const BenchProblem p = bench_problem4_2();
+    const int M = 200, MAX_T = 100, SIMULATOR_US = 50; // a stand-in simulator: sleeps per evaluation
+    const std::string path = "bench_replay.evals";
+
+    auto objective = [&](const Individual& ind) {
+        std::this_thread::sleep_for(std::chrono::microseconds(SIMULATOR_US));
+        return p.objective(ind);
+    };
+
+    std::cout << "\n============================================================\n";
+    std::cout << "Evaluation record and replay (" << p.name << ", m=" << M << ", T=" << MAX_T << ", simulator "
+        << SIMULATOR_US << " us per evaluation)\n";
+    std::cout << "============================================================\n";
+    std::cout << std::left << std::setw(28) << "configuration" << std::right << std::setw(12) << "evaluations"
+        << std::setw(14) << "record (s)" << std::setw(14) << "replay (s)" << std::setw(12) << "MB" << std::setw(14)
+        << "same run" << "\n";
+
+    struct Setup {
+        std::string label;
+        std::function<void(Civilization&)> configure;
+    };
+    const std::vector<Setup> setups = {
+        { "default", [](Civilization&) {} },
+        { "adaptive + repair + bandit", [](Civilization& civ) {
+            civ.set_adaptive_operators(true);
+            civ.set_repair(Civilization::REPAIR_PROJECT, welded_beam_problem.linear_constraints());
+            civ.set_evaluation_bandit(true);
+        } },
+    };
+
+    bool all_same = true;
+    for (const Setup& setup : setups) {
+        auto make = [&](Civilization::ObjFunc obj) {
+            auto civ = std::make_unique<Civilization>(M, p.n, p.lb, p.ub, std::move(obj), p.constraints, 1400u);
+            civ->set_verbose(false);
+            setup.configure(*civ);
+            civ->initialize();
+            return civ;
+        };
+
+        auto recorder = std::make_shared<EvaluationRecorder>(path, p.n);
+        auto recorded = make(objective);
+        recorded->set_evaluation_recorder(recorder);
+        auto start = BenchClock::now();
+        run_time_steps(*recorded, MAX_T);
+        recorded->evaluate_population();
+        const double record_s = seconds_since(start);
+        recorder->close();
+
+        EvaluationReplay replay(path);
+        auto replayed = make([](const Individual&) -> double {
+            throw std::logic_error("replay must not call the simulator");
+        });
+        replayed->set_batch_evaluator(replay.batch_evaluator());
+        start = BenchClock::now();
+        run_time_steps(*replayed, MAX_T);
+        replayed->evaluate_population();
+        const double replay_s = seconds_since(start);
+
+        const bool same = replayed->evaluations() == recorded->evaluations() &&
+            replayed->get_best_ever().objective_value == recorded->get_best_ever().objective_value &&
+            replayed->get_best_ever().variables == recorded->get_best_ever().variables && replay.misses() == 0;
+        all_same = all_same && same;
+        const double mb = static_cast<double>(replay.size()) * sizeof(double) *
+            (p.n + 1 + replay.num_constraints()) / (1024.0 * 1024.0);
+        std::cout << std::left << std::setw(28) << setup.label << std::right << std::setw(12) << recorded->evaluations()
+            << std::fixed << std::setprecision(3) << std::setw(14) << record_s << std::setw(14) << replay_s
+            << std::setw(12) << std::setprecision(2) << mb << std::setw(14) << (same ? "yes" : "NO") << "\n";
+    }
+    std::remove(path.c_str());
+    std::cout << "(replay serves the recorded results through set_batch_evaluator; the simulator is never called)\n";
+    std::cout << std::defaultfloat << std::setprecision(6);
+    return all_same ? 0 : 1;
+}
@@ -43,6 +43,13 @@ int problem4_1() {
     std::cout << "Starting Simulation (" << NUM_RUNS << " Runs, " << MAX_T << " Iterations each)...\n";
     std::cout << "Logging data to 'simulation_data.csv'...\n\n";
 
+    // One civilization for all runs; reseed() starts each run in place
+    Civilization myCiv(
+        m, n, lower_bounds, upper_bounds,
+        [&](const Individual& ind) { return problem4_1.get_objective(ind); },
+        [&](const Individual& ind) { return problem4_1.get_constraints_violation(ind); }
+    );
+
     // --- RUN LOOP ---
     for (int run = 1; run <= NUM_RUNS; ++run) {
         // Reset evaluations
@@ -58,14 +65,7 @@ int problem4_1() {
             current_seed = run + 10;
         }
 
-        Civilization myCiv(
-            m, n, lower_bounds, upper_bounds,
-            [&](const Individual& ind) { return problem4_1.get_objective(ind); },
-            [&](const Individual& ind) { return problem4_1.get_constraints_violation(ind); },
-            current_seed
-        );
-
-        myCiv.initialize();
+        myCiv.reseed(current_seed);
         int t = 0;
 
         // --- TIME LOOP (Step 9 & 10) ---
@@ -203,6 +203,13 @@ int problem4_2() {
     std::cout << "Starting Welded Beam Simulation (" << NUM_RUNS << " Runs, " << MAX_T << " Iterations each)...\n";
     std::cout << "Logging data to 'simulation_data_welded_beam.csv'...\n\n";
 
+    // One civilization with the Welded Beam functors for all runs
+    Civilization myCiv(
+        m, n, lower_bounds, upper_bounds,
+        [&](const Individual& ind) { return problem4_2.get_objective(ind); },
+        [&](const Individual& ind) { return problem4_2.get_constraints_violation(ind); }
+    );
+
     // --- RUN LOOP ---
     for (int run = 1; run <= NUM_RUNS; ++run) {
         // Reset evaluations count
@@ -219,15 +226,8 @@ int problem4_2() {
             current_seed = run + 100;
         }
 
-        // Instantiate Civilization with Welded Beam Functors
-        Civilization myCiv(
-            m, n, lower_bounds, upper_bounds,
-            [&](const Individual& ind) { return problem4_2.get_objective(ind); },
-            [&](const Individual& ind) { return problem4_2.get_constraints_violation(ind); },
-            current_seed
-        );
-
-        myCiv.initialize();
+        // Start the run in place with this seed
+        myCiv.reseed(current_seed);
         int t = 0;
 
         // --- TIME LOOP (Steps 9 & 10) ---
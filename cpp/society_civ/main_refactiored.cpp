@@ -1,15 +1,28 @@
+#include "Benchmarks.h"
+#include "BlockWriter.h"
 #include "Civilization.h"
+#include "CivilizationPool.h"
+#include "EvaluationRecording.h"
+#include "InfluenceTree.h"
 #include "Koziel_and_Michalewicz.h"
+#include "SequentialStopping.h"
+#include "TrajectoryAnalytics.h"
+#include "TrajectoryLog.h"
 #include "WeldedBeamDesign.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <cstdio>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <limits>
+#include <memory>
 #include <numeric>
 #include <random>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <type_traits>
 #include <utility>
@@ -68,17 +81,25 @@ template <typename T>
 struct has_get_constraints_violation<T, std::void_t<decltype(std::declval<const T&>().get_constraints_violation(std::declval<const Individual&>()))>>
     : std::true_type {};
 
+// linear_constraints(): cheap constraints for repair before evaluation
 template <typename T, typename = void>
-struct has_get_constraints_raw_values : std::false_type {};
+struct has_linear_constraints : std::false_type {};
 template <typename T>
-struct has_get_constraints_raw_values<T, std::void_t<decltype(std::declval<const T&>().get_constraints_raw_values(std::declval<const Individual&>()))>>
+struct has_linear_constraints<T, std::void_t<decltype(std::declval<const T&>().linear_constraints())>>
+    : std::true_type {};
+
+// get_constraints_violation(ind, out): writes into an existing vector
+template <typename T, typename = void>
+struct has_constraint_writer : std::false_type {};
+template <typename T>
+struct has_constraint_writer<T, std::void_t<decltype(std::declval<const T&>().get_constraints_violation(
+    std::declval<const Individual&>(), std::declval<std::vector<double>&>()))>>
     : std::true_type {};
 
-// Member field detection: evaluations
 template <typename T, typename = void>
-struct has_evaluations_field : std::false_type {};
+struct has_get_constraints_raw_values : std::false_type {};
 template <typename T>
-struct has_evaluations_field<T, std::void_t<decltype(std::declval<const T&>().evaluations)>>
+struct has_get_constraints_raw_values<T, std::void_t<decltype(std::declval<const T&>().get_constraints_raw_values(std::declval<const Individual&>()))>>
     : std::true_type {};
 
 // -------------------------------
@@ -128,17 +149,34 @@ static std::vector<double> call_raw_constraints(ProblemT& p, const Individual& i
     }
 }
 
-template <typename ProblemT>
-static long long call_eval_count(const ProblemT& p) {
-    if constexpr (has_evaluations_field<ProblemT>::value) {
-        return static_cast<long long>(p.evaluations);
-    }
-    return -1;
-}
-
 // -------------------------------
 // Common runner for any problem
 // -------------------------------
+
+// Parallelism switches; every level runs on the shared TaskRuntime
+struct RunSettings {
+    bool parallel_runs = false;       // independent seeds concurrently
+    bool parallel_societies = false;  // leader selection per society
+    bool parallel_evaluation = false; // objective/constraints per individual
+    int licenses = 0;                 // > 0: concurrent evaluations allowed over all runs
+    std::string license_dir;          // lock-file directory shared with other processes
+    // Sequential stopping: > 0 replaces the fixed run count with "add runs
+    // until the confidence interval is this wide" (see SequentialStopping)
+    double ci_width = 0.0;
+    bool success_rate = false;        // interval on the success rate instead of the mean best objective
+    double success_threshold = 0.0;   // feasible best objective at or below this counts as a success
+    int min_runs = 5;
+    int max_runs = 200;
+    bool track_influence = false;     // add the InfluencedBy column to the trajectory log
+    // Repair against the problem's cheap linear constraints before evaluation
+    // (problems without linear_constraints() are run unchanged)
+    Civilization::RepairMode repair = Civilization::REPAIR_NONE;
+    // Evaluation record/replay through '<problem>.evals'; both fix the seeds
+    // (base_seed + run) so that a replay asks for the recorded designs
+    bool record_evaluations = false;
+    bool replay_evaluations = false;
+};
+
 template <typename ProblemT>
 static int run_problem(
     const std::string& name,
@@ -150,7 +188,8 @@ static int run_problem(
     int max_t,
     int num_runs,
     bool use_random_seed,
-    unsigned base_seed
+    unsigned base_seed,
+    const RunSettings& settings = RunSettings()
 ) {
     std::random_device rd;
 
@@ -163,10 +202,37 @@ static int run_problem(
     std::vector<long long> evals;
     evals.reserve(static_cast<size_t>(num_runs));
 
+    // One token budget for all runs of this study
+    std::shared_ptr<LicensePool> licenses;
+    if (settings.licenses > 0) licenses = std::make_shared<LicensePool>(settings.licenses, settings.license_dir);
+    std::vector<double> license_waits;
+    std::vector<Civilization::RepairStats> repairs;
+
+    // With a target interval width, num_runs is only the default study size
+    // and the study grows until the interval is narrow enough
+    std::unique_ptr<SequentialStopping> stopping;
+    if (settings.ci_width > 0.0) {
+        SequentialStopping::Config config;
+        config.ci_width = settings.ci_width;
+        config.use_success_rate = settings.success_rate;
+        config.success_threshold = settings.success_threshold;
+        config.min_runs = settings.min_runs;
+        config.max_runs = settings.max_runs;
+        stopping = std::make_unique<SequentialStopping>(config);
+    }
+
     std::cout << "\n============================================================\n";
-    std::cout << "Starting " << name << " (" << num_runs << " runs, "
-        << max_t << " iterations each)\n";
+    std::cout << "Starting " << name << " (";
+    if (stopping) {
+        std::cout << "sequential: " << (settings.success_rate ? "success rate" : "mean best objective")
+            << " to a 95% CI width of " << settings.ci_width << ", up to " << stopping->config().max_runs << " runs, ";
+    }
+    else {
+        std::cout << num_runs << " runs, ";
+    }
+    std::cout << max_t << " iterations each)\n";
     std::cout << "m=" << m_pop_size << ", n=" << n_vars << "\n";
+    if (settings.record_evaluations || settings.replay_evaluations) use_random_seed = false;
     std::cout << "Seed mode: " << (use_random_seed ? "RANDOM" : "DETERMINISTIC")
         << (use_random_seed ? "" : (" (base_seed=" + std::to_string(base_seed) + ")"))
         << "\n";
@@ -183,31 +249,72 @@ static int run_problem(
         };
 
     const std::string csvFile = safe_filename(name) + ".csv";
-    std::ofstream logFile(csvFile);
+    BlockWriter log_writer(csvFile);
+    std::ostream& logFile = log_writer.stream();
     // Write CSV Headers
-    logFile << "Run,Time,AgentID,x1,x2,Objective,ClusterID,IsLocalLeader,IsSuperLeader\n";
+    logFile << (settings.track_influence ? TrajectoryLog::CSV_HEADER_INFLUENCE : TrajectoryLog::CSV_HEADER) << "\n";
 
-    std::cout << "Starting Simulation (" << num_runs << " Runs, " << max_t << " Iterations each)...\n";
+    if (!stopping) std::cout << "Starting Simulation (" << num_runs << " Runs, " << max_t << " Iterations each)...\n";
     std::cout << "Logging data to '" << csvFile << "'...\n\n";
 
-    for (int run = 1; run <= num_runs; ++run) {
-        // Reset evaluations if supported
-        if constexpr (std::is_member_function_pointer_v<decltype(&ProblemT::reset_evaluations)>) {
-            problem.reset_evaluations();
+    const std::string evalsFile = safe_filename(name) + ".evals";
+    std::shared_ptr<EvaluationRecorder> recorder;
+    std::unique_ptr<EvaluationReplay> replay;
+    if (settings.replay_evaluations) {
+        replay = std::make_unique<EvaluationReplay>(evalsFile);
+        if (replay->size() > 0 && replay->num_variables() != n_vars) {
+            std::cerr << evalsFile << ": recorded with " << replay->num_variables() << " variables, problem has " << n_vars << "\n";
+            return 1;
         }
+        std::cout << "Replaying " << replay->size() << " recorded evaluations from '" << evalsFile << "'...\n\n";
+    }
+    else if (settings.record_evaluations) {
+        recorder = std::make_shared<EvaluationRecorder>(evalsFile, n_vars);
+        std::cout << "Recording evaluations to '" << evalsFile << "'...\n\n";
+    }
 
-        unsigned seed = use_random_seed ? rd() : (base_seed + static_cast<unsigned>(run));
-        seeds.push_back(seed);
-
-        Civilization civ(
+    // Seeds of a batch are drawn before it starts so that parallel runs see
+    // the same sequence
+    auto schedule_runs = [&](int count) {
+        for (int k = 0; k < count; ++k) {
+            const int run = static_cast<int>(seeds.size()) + 1;
+            seeds.push_back(use_random_seed ? rd() : (base_seed + static_cast<unsigned>(run)));
+        }
+        all_run_bests.resize(seeds.size(), Individual(n_vars));
+        evals.resize(seeds.size(), 0);
+        license_waits.resize(seeds.size(), 0.0);
+        repairs.resize(seeds.size());
+    };
+
+    // Executes one run, writing its trajectory to 'log'
+    // Engines are reused across runs (one per concurrently executing run)
+    CivilizationPool engines([&]() {
+        auto civ = std::make_unique<Civilization>(
             m_pop_size, n_vars,
             lower_bounds, upper_bounds,
             [&](const Individual& ind) { return call_objective(problem, ind); },
-            [&](const Individual& ind) { return call_constraints_violation(problem, ind); },
-            seed
+            [&](const Individual& ind) { return call_constraints_violation(problem, ind); }
         );
+        if constexpr (has_constraint_writer<ProblemT>::value) {
+            civ->set_constraint_writer([&](const Individual& ind, std::vector<double>& out) {
+                problem.get_constraints_violation(ind, out);
+            });
+        }
+        civ->set_parallel_societies(settings.parallel_societies);
+        civ->set_parallel_evaluation(settings.parallel_evaluation);
+        civ->set_influence_tracking(settings.track_influence);
+        if (recorder) civ->set_evaluation_recorder(recorder);
+        if (replay) civ->set_batch_evaluator(replay->batch_evaluator());
+        if constexpr (has_linear_constraints<ProblemT>::value) {
+            if (settings.repair != Civilization::REPAIR_NONE) civ->set_repair(settings.repair, problem.linear_constraints());
+        }
+        return civ;
+    });
 
-        civ.initialize();
+    auto execute_run = [&](int run, std::ostream& log) {
+        CivilizationPool::Lease engine = engines.acquire(seeds[run - 1]);
+        Civilization& civ = *engine;
+        if (licenses) civ.set_license_pool(licenses, "run " + std::to_string(run));
 
         for (int t = 0; t < max_t; ++t) {
             civ.cluster_population();
@@ -219,25 +326,86 @@ static int run_problem(
 
 
             // Log Data for this Time Step
-            civ.log_state(logFile, run, t);
+            civ.log_state(log, run, t);
         }
 
         // IMPORTANT: Ensure final positions are evaluated before selecting best
         civ.evaluate_population();
 
-        Individual run_best = civ.get_best_solution();
-        all_run_bests.push_back(run_best);
+        all_run_bests[run - 1] = civ.get_best_solution();
+        // Counted by the civilization itself so that concurrent runs sharing
+        // 'problem' still report per-run figures
+        evals[run - 1] = civ.evaluations();
+        license_waits[run - 1] = civ.license_wait_seconds();
+        repairs[run - 1] = civ.get_repair_stats();
+    };
+
+    // Executes runs [first, last]
+    auto execute_runs = [&](int first, int last) {
+        if (settings.parallel_runs) {
+            // Runs stream into private spill files that are appended in run
+            // order, so memory use does not grow with the trajectory length
+            auto spill_name = [&](int run) { return csvFile + ".run" + std::to_string(run) + ".part"; };
+            TaskRuntime::instance().parallel_for(first, last + 1, [&](int run) {
+                std::ofstream log(spill_name(run), std::ios::binary | std::ios::trunc);
+                if (!log) throw std::runtime_error("cannot create '" + spill_name(run) + "'");
+                execute_run(run, log);
+                log.close();
+                if (!log) throw std::runtime_error("cannot write '" + spill_name(run) + "'");
+            });
+            for (int run = first; run <= last; ++run) {
+                {
+                    std::ifstream log(spill_name(run), std::ios::binary);
+                    if (!log) throw std::runtime_error("cannot read '" + spill_name(run) + "'");
+                    if (log.peek() != std::ifstream::traits_type::eof()) logFile << log.rdbuf();
+                }
+                std::remove(spill_name(run).c_str());
+            }
+        }
+        else {
+            for (int run = first; run <= last; ++run) execute_run(run, logFile);
+        }
+    };
+
+    const auto runs_start = std::chrono::steady_clock::now();
+    if (stopping) {
+        // Batches as wide as the runtime (one run at a time when runs are
+        // serial); the interval is checked after every batch
+        const int parallelism = settings.parallel_runs ? static_cast<int>(TaskRuntime::instance().max_threads()) : 1;
+        for (int batch = stopping->next_batch(parallelism); batch > 0; batch = stopping->next_batch(parallelism)) {
+            const int first = static_cast<int>(seeds.size()) + 1;
+            schedule_runs(batch);
+            execute_runs(first, first + batch - 1);
+            for (int run = first; run < first + batch; ++run) {
+                const Individual& best = all_run_bests[run - 1];
+                stopping->add(best.objective_value, Civilization::is_feasible(best));
+            }
+        }
+        num_runs = stopping->runs();
+    }
+    else {
+        schedule_runs(num_runs);
+        execute_runs(1, num_runs);
+    }
+    log_writer.close();
+    const double runs_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - runs_start).count();
+    if (recorder) recorder->close();
 
-        long long ev = call_eval_count(problem);
-        evals.push_back(ev);
+    for (int run = 1; run <= num_runs; ++run) {
+        const Individual& run_best = all_run_bests[run - 1];
+        const long long ev = evals[run - 1];
 
         std::cout << "Run " << std::setw(2) << run
-            << " | seed=" << seed
+            << " | seed=" << seeds[run - 1]
             << " | obj=" << std::fixed << std::setprecision(10) << run_best.objective_value
             << " | sumV=" << std::fixed << std::setprecision(10) << sum_violations(run_best.constraint_violations)
             << " | X=" << format_vec(run_best.variables, 6);
 
         if (ev >= 0) std::cout << " | evals=" << ev;
+        if (licenses) std::cout << " | license_wait=" << std::setprecision(3) << license_waits[run - 1] << "s";
+        if (repairs[run - 1].checked > 0) {
+            std::cout << " | projected=" << repairs[run - 1].projected << " rejected=" << repairs[run - 1].rejected;
+        }
         std::cout << "\n";
     }
 
@@ -277,6 +445,35 @@ static int run_problem(
     std::cout << "Final Statistical Report (" << name << ", " << num_runs << " runs)\n";
     std::cout << "------------------------------------------------------------\n";
     std::cout << "Calculated Average Objective: " << std::fixed << std::setprecision(10) << avg_obj << "\n";
+    if (stopping) {
+        std::cout << "Sequential stopping: " << num_runs << " runs, "
+            << (settings.success_rate ? "success rate " : "mean best objective ")
+            << (settings.success_rate ? stopping->success_rate() : stopping->mean())
+            << ", 95% CI [" << stopping->estimate() - stopping->half_width()
+            << ", " << stopping->estimate() + stopping->half_width() << "], "
+            << (stopping->converged() ? "target width reached" : "run cap reached before the target width") << "\n";
+    }
+    Civilization::RepairStats repaired;
+    for (const auto& r : repairs) {
+        repaired.checked += r.checked;
+        repaired.projected += r.projected;
+        repaired.rejected += r.rejected;
+        repaired.unrepaired += r.unrepaired;
+    }
+    if (repaired.checked > 0) {
+        std::cout << "Cheap-constraint repair: " << repaired.checked << " candidates checked, " << repaired.projected
+            << " projected, " << repaired.rejected << " rejected (evaluations saved), " << repaired.unrepaired
+            << " not repairable\n";
+    }
+
+    if (recorder) {
+        std::cout << "Evaluation recording: " << recorder->records() << " evaluations written to '" << evalsFile
+            << "' (runs took " << std::setprecision(3) << runs_seconds << " s)\n";
+    }
+    if (replay) {
+        std::cout << "Evaluation replay: " << replay->lookups() << " evaluations served from '" << evalsFile
+            << "' (runs took " << std::setprecision(3) << runs_seconds << " s)\n";
+    }
 
     print_snippet("BEST", best_ind);
     print_snippet("AVERAGE (Closest to Mean)", avg_ind);
@@ -288,7 +485,7 @@ static int run_problem(
 // -------------------------------
 // Problem entry points
 // -------------------------------
-static int run_problem4_1() {
+static int run_problem4_1(const RunSettings& settings) {
     TwoVariableDesign p;
 
     const int n = 2;
@@ -302,10 +499,10 @@ static int run_problem4_1() {
     std::vector<double> lb = { 13.0, 0.0 };
     std::vector<double> ub = { 100.0, 100.0 };
 
-    return run_problem("problem4_1", p, n, lb, ub, m, MAX_T, NUM_RUNS, USE_RANDOM_SEED, BASE_SEED);
+    return run_problem("problem4_1", p, n, lb, ub, m, MAX_T, NUM_RUNS, USE_RANDOM_SEED, BASE_SEED, settings);
 }
 
-static int run_problem4_2() {
+static int run_problem4_2(const RunSettings& settings) {
     WeldedBeamDesign p;
 
     const int n = 4;
@@ -320,7 +517,72 @@ static int run_problem4_2() {
     std::vector<double> lb = { 0.1, 0.1, 0.1, 0.1 };
     std::vector<double> ub = { 2.0, 10.0, 10.0, 2.0 };
 
-    return run_problem("problem4_2", p, n, lb, ub, m, MAX_T, NUM_RUNS, USE_RANDOM_SEED, BASE_SEED);
+    return run_problem("problem4_2", p, n, lb, ub, m, MAX_T, NUM_RUNS, USE_RANDOM_SEED, BASE_SEED, settings);
+}
+
+// Validates a trajectory CSV log and writes it in TrajectoryLog's binary format
+static int convert_log(const std::string& csv_path, const std::string& binary_path) {
+    const auto start = std::chrono::steady_clock::now();
+    TrajectoryLog log;
+    const TrajectoryLog::ParseReport report = log.parse_csv(csv_path);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << csv_path << ": " << report.rows << " rows, " << log.steps().size() << " steps, "
+        << report.errors << " rejected line(s), " << std::fixed << std::setprecision(1)
+        << report.bytes / 1048576.0 / seconds << " MB/s\n";
+    for (const auto& message : report.messages) std::cout << "  " << message << "\n";
+    if (report.rows == 0) return 1;
+
+    log.write_binary(binary_path);
+    std::cout << "Wrote " << binary_path << "\n";
+    return report.ok() ? 0 : 2;
+}
+
+// Per-run, per-step metrics of a trajectory log (CSV or binary) into
+// PREFIX_steps.csv and PREFIX_runs.csv
+static int analyze_log(const std::string& log_path, const std::string& prefix) {
+    const auto start = std::chrono::steady_clock::now();
+    TrajectoryLog log;
+    const bool binary = log_path.size() > 4 && log_path.compare(log_path.size() - 4, 4, ".bin") == 0;
+    if (binary) {
+        log.read_binary(log_path);
+    }
+    else {
+        const TrajectoryLog::ParseReport report = log.parse_csv(log_path);
+        if (report.errors > 0) std::cout << log_path << ": " << report.errors << " rejected line(s) skipped\n";
+        for (const auto& message : report.messages) std::cout << "  " << message << "\n";
+    }
+    if (log.size() == 0) {
+        std::cerr << log_path << ": no rows\n";
+        return 1;
+    }
+
+    TrajectoryAnalytics analytics;
+    analytics.compute(log);
+    analytics.write_steps_csv(prefix + "_steps.csv");
+    analytics.write_runs_csv(prefix + "_runs.csv");
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << log_path << ": " << log.size() << " rows, " << analytics.runs.size() << " runs, "
+        << analytics.steps.size() << " steps in " << std::fixed << std::setprecision(2) << seconds << " s\n";
+    std::cout << "Wrote " << prefix << "_steps.csv and " << prefix << "_runs.csv\n";
+    return 0;
+}
+
+// Influence forest of one step of a trajectory log recorded with --influence
+static int show_influence(const std::string& log_path, int run, int time) {
+    TrajectoryLog log;
+    const bool binary = log_path.size() > 4 && log_path.compare(log_path.size() - 4, 4, ".bin") == 0;
+    if (binary) log.read_binary(log_path);
+    else log.parse_csv(log_path);
+    if (!log.has_influence()) {
+        std::cerr << log_path << ": no InfluencedBy column (record it with --influence)\n";
+        return 1;
+    }
+    const InfluenceTree tree(log, run, time);
+    std::cout << "Run " << run << ", time " << time << ": " << tree.agents() << " agents, " << tree.roots().size()
+        << " root(s), largest basin " << std::fixed << std::setprecision(1) << 100.0 * tree.top_share() << "%\n";
+    tree.print(std::cout);
+    return 0;
 }
 
 // CLI usage:
@@ -328,19 +590,162 @@ static int run_problem4_2() {
 //   society_civ.exe 4_1        -> problem4_1
 //   society_civ.exe 4_2        -> problem4_2
 //   society_civ.exe all        -> both
+//   society_civ.exe bench_runtime -> nested-parallelism oversubscription benchmark
+//   society_civ.exe bench_adaptive -> fixed vs self-adaptive operator probabilities
+//   society_civ.exe bench_epsilon  -> evaluations to first feasible with an epsilon schedule
+//   society_civ.exe bench_portfolio -> portfolio of configurations vs each one alone
+//   society_civ.exe bench_schedule -> cost-aware (longest-predicted-first) evaluation dispatch
+//   society_civ.exe bench_lsh      -> approximate (LSH) vs exact nearest-leader search
+//   society_civ.exe bench_storage  -> out-of-core population storage / checkpoint restore
+//   society_civ.exe bench_http     -> HTTP evaluation service: per-design vs batched requests
+//   society_civ.exe bench_licenses -> concurrent runs sharing a license-token budget
+//   society_civ.exe bench_leaders  -> top-k leader sets vs unbounded leader selection
+//   society_civ.exe bench_csv      -> trajectory CSV reader throughput
+//   society_civ.exe convert_log IN.csv OUT.bin -> validate a trajectory log and convert it to binary
+//   society_civ.exe bench_analytics -> trajectory metrics throughput against a script-style pass
+//   society_civ.exe analyze_log IN OUT_PREFIX -> per-step/per-run metrics of a trajectory log (.csv or .bin)
+//   society_civ.exe bench_io       -> log writer backends (ofstream, pwrite, io_uring, O_DIRECT)
+//   society_civ.exe bench_reuse    -> per-run setup cost: new civilization vs reseeded pooled engines
+//   society_civ.exe bench_influence -> cost of influence tracking and influence-tree queries
+//   society_civ.exe influence LOG RUN TIME -> influence trees of one step (log recorded with --influence)
+//   society_civ.exe bench_latency -> p50/p99 step time for interactive use (and allocations per step when built with -DCIV_COUNT_ALLOCATIONS)
+//   society_civ.exe bench_continuation -> welded-beam parameter sweeps, cold starts vs continuation
+//   society_civ.exe bench_repair -> cheap-constraint repair (project / reject) against plain evaluation
+//   society_civ.exe bench_hot_cold -> step phase times, Individual vs flat distance loops
+//   society_civ.exe bench_bandit -> evaluations to target with bandit allocation of moves across societies
+//   society_civ.exe bench_coalesce -> concurrent runs' batches coalesced into one evaluator call
+//   society_civ.exe bench_societies -> society sizes, step time and quality with hub cap / minimum society size
+//   society_civ.exe bench_clustering -> distances computed, reused and pruned by the hub-center clustering, checked against an unpruned reference
+//   society_civ.exe bench_replay -> a run recorded against a slow simulator, then replayed from memory
+// Options (after the mode):
+//   --threads N    hard cap on threads used by the shared task runtime (default: all cores)
+//   --parallel     run seeds, societies and evaluations in parallel
+//   --licenses N   at most N evaluations at once over all runs (license tokens)
+//   --license-dir D  share the token budget with other processes using directory D
+//   --ci-width W   instead of a fixed run count, add runs until the 95% CI of
+//                  the mean best objective is at most W wide
+//   --success-below V  ... the CI of the rate of runs with a feasible best <= V
+//   --min-runs N / --max-runs N  bounds of a sequential study (default 5 / 200)
+//   --influence    log which agent every agent moved toward (InfluencedBy column)
+//   --repair project|reject  repair candidates against the problem's cheap linear constraints before evaluation
+//   --record       write every evaluation to <problem>.evals (seeds fixed to base_seed + run)
+//   --replay       serve evaluations from <problem>.evals instead of the problem (same seeds and options)
 int main(int argc, char** argv) {
     std::string mode = "4_1";
     if (argc >= 2) mode = argv[1];
 
-    if (mode == "4_1" || mode == "problem4_1") return run_problem4_1();
-    if (mode == "4_2" || mode == "problem4_2") return run_problem4_2();
+    RunSettings settings;
+    std::vector<std::string> inputs; // positional arguments of convert_log / analyze_log / influence
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            TaskRuntime::set_max_threads(static_cast<unsigned>(std::stoul(argv[++i])));
+        }
+        else if (arg == "--licenses" && i + 1 < argc) {
+            settings.licenses = std::stoi(argv[++i]);
+        }
+        else if (arg == "--license-dir" && i + 1 < argc) {
+            settings.license_dir = argv[++i];
+        }
+        else if (arg == "--ci-width" && i + 1 < argc) {
+            settings.ci_width = std::stod(argv[++i]);
+        }
+        else if (arg == "--success-below" && i + 1 < argc) {
+            settings.success_rate = true;
+            settings.success_threshold = std::stod(argv[++i]);
+        }
+        else if (arg == "--min-runs" && i + 1 < argc) {
+            settings.min_runs = std::stoi(argv[++i]);
+        }
+        else if (arg == "--max-runs" && i + 1 < argc) {
+            settings.max_runs = std::stoi(argv[++i]);
+        }
+        else if (arg == "--influence") {
+            settings.track_influence = true;
+        }
+        else if (arg == "--repair" && i + 1 < argc) {
+            const std::string how = argv[++i];
+            if (how == "project") settings.repair = Civilization::REPAIR_PROJECT;
+            else if (how == "reject") settings.repair = Civilization::REPAIR_REJECT;
+            else {
+                std::cerr << "--repair expects 'project' or 'reject'\n";
+                return 1;
+            }
+        }
+        else if (arg == "--record") {
+            settings.record_evaluations = true;
+        }
+        else if (arg == "--replay") {
+            settings.replay_evaluations = true;
+        }
+        else if (arg == "--parallel") {
+            settings.parallel_runs = true;
+            settings.parallel_societies = true;
+            settings.parallel_evaluation = true;
+        }
+        else if ((mode == "convert_log" || mode == "analyze_log" || mode == "influence") && arg.rfind("--", 0) != 0) {
+            inputs.push_back(arg);
+        }
+        else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    if (mode == "4_1" || mode == "problem4_1") return run_problem4_1(settings);
+    if (mode == "4_2" || mode == "problem4_2") return run_problem4_2(settings);
     if (mode == "all") {
-        int a = run_problem4_1();
-        int b = run_problem4_2();
+        int a = run_problem4_1(settings);
+        int b = run_problem4_2(settings);
         return (a != 0 || b != 0) ? 1 : 0;
     }
+    if (mode == "bench_runtime") return bench_nested_parallelism();
+    if (mode == "bench_adaptive") return bench_adaptive_operators();
+    if (mode == "bench_epsilon") return bench_epsilon_schedule();
+    if (mode == "bench_portfolio") return bench_portfolio();
+    if (mode == "bench_schedule") return bench_cost_scheduling();
+    if (mode == "bench_lsh") return bench_lsh_nearest();
+    if (mode == "bench_storage") return bench_population_storage();
+    if (mode == "bench_http") return bench_http_evaluator();
+    if (mode == "bench_licenses") return bench_license_budget();
+    if (mode == "bench_leaders") return bench_leader_cap();
+    if (mode == "bench_csv") return bench_csv_reader();
+    if (mode == "convert_log") {
+        if (inputs.size() != 2) {
+            std::cerr << "Usage: " << argv[0] << " convert_log IN.csv OUT.bin [--threads N]\n";
+            return 1;
+        }
+        return convert_log(inputs[0], inputs[1]);
+    }
+    if (mode == "bench_analytics") return bench_trajectory_analytics();
+    if (mode == "bench_io") return bench_block_writer();
+    if (mode == "bench_reuse") return bench_engine_reuse();
+    if (mode == "bench_influence") return bench_influence_log();
+    if (mode == "bench_latency") return bench_step_latency();
+    if (mode == "bench_continuation") return bench_continuation();
+    if (mode == "bench_repair") return bench_cheap_repair();
+    if (mode == "bench_hot_cold") return bench_hot_cold();
+    if (mode == "bench_bandit") return bench_evaluation_bandit();
+    if (mode == "bench_coalesce") return bench_evaluation_coalescer();
+    if (mode == "bench_societies") return bench_society_limits();
+    if (mode == "bench_clustering") return bench_cluster_pruning();
+    if (mode == "bench_replay") return bench_evaluation_replay();
+    if (mode == "influence") {
+        if (inputs.size() != 3) {
+            std::cerr << "Usage: " << argv[0] << " influence LOG RUN TIME\n";
+            return 1;
+        }
+        return show_influence(inputs[0], std::stoi(inputs[1]), std::stoi(inputs[2]));
+    }
+    if (mode == "analyze_log") {
+        if (inputs.size() != 2) {
+            std::cerr << "Usage: " << argv[0] << " analyze_log IN OUT_PREFIX [--threads N]\n";
+            return 1;
+        }
+        return analyze_log(inputs[0], inputs[1]);
+    }
 
     std::cerr << "Unknown mode: " << mode << "\n";
-    std::cerr << "Usage: " << argv[0] << " [4_1|4_2|all]\n";
+    std::cerr << "Usage: " << argv[0] << " [4_1|4_2|all|bench_runtime|bench_adaptive|bench_epsilon|bench_portfolio|bench_schedule|bench_lsh|bench_storage|bench_http|bench_licenses|bench_leaders|bench_csv|convert_log|bench_analytics|analyze_log|bench_io|bench_reuse|bench_influence|influence|bench_latency|bench_continuation|bench_repair|bench_hot_cold|bench_bandit|bench_coalesce|bench_societies|bench_clustering|bench_replay] [--threads N] [--parallel] [--licenses N [--license-dir D]] [--ci-width W [--success-below V] [--min-runs N] [--max-runs N]] [--influence] [--repair project|reject] [--record|--replay]\n";
     return 1;
 }